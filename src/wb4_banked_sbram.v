@@ -0,0 +1,136 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_banked_sbram.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_banked_sbram
+Description  : generic_sbram drop-in that tiles a deep memory across several
+               bank sized generic_sbram instances.
+
+Additional Comments:
+   Same ports and read latency as generic_sbram. The upper address bits pick
+   the bank: every bank gets the lower write address and data, only the
+   selected one its write enable, and every bank reads the lower read address
+   on each clock. The selected read bank is registered with the read, on the
+   read clock, so the only logic left behind the bank output registers is one
+   mux level per bank address bit. One word per clock on each port.
+   P_BANK_ADDR_MSB >= P_SBRAM_ADDR_MSB builds a single generic_sbram.
+   Only the banks that hold entries below P_SBRAM_DEPTH are built, so a non
+   power of 2 depth doesn't round the storage up by more than one bank.
+*/
+module wb4_banked_sbram #(
+  parameter integer P_SBRAM_DATA_MSB  = 7,  // Data Width-1
+  parameter integer P_SBRAM_ADDR_MSB  = 9,  // $clog2(Depth)-1
+  parameter integer P_SBRAM_DEPTH     = 2**(P_SBRAM_ADDR_MSB+1), // Entries used
+  parameter integer P_SBRAM_MASK_MSB  = 0,  // Mask lanes-1
+  parameter integer P_BANK_ADDR_MSB   = 7,  // $clog2(Bank Depth)-1
+  parameter integer P_SBRAM_HAS_FILE  = 0,  //
+  parameter integer P_SBRAM_INIT_FILE = 0   //
+)(
+  input                       i_ce,    // Chip Enable
+  input                       i_wclk,  // Write Clock
+  input                       i_rclk,  // Read Clock
+  input  [P_SBRAM_ADDR_MSB:0] i_waddr, // Write Address
+  input  [P_SBRAM_ADDR_MSB:0] i_raddr, // Read Address
+  input                       i_we,    // Write Enable
+  input  [P_SBRAM_MASK_MSB:0] i_mask,  // 0=writes, 1=masks
+  input  [P_SBRAM_DATA_MSB:0] i_wdata, // Write Data
+  output [P_SBRAM_DATA_MSB:0] o_rdata  // Registered Read Data
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_WIDTH = P_SBRAM_DATA_MSB+1;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  genvar bank;
+  generate
+    if (P_BANK_ADDR_MSB >= P_SBRAM_ADDR_MSB) begin: single_bank_gen
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Single Port BRAM
+      // Description : Inferrable Single Port Block RAM.
+      ///////////////////////////////////////////////////////////////////////////////
+      generic_sbram #(
+        // Compile time configurable parameters
+        .P_SBRAM_DATA_MSB (P_SBRAM_DATA_MSB),
+        .P_SBRAM_ADDR_MSB (P_SBRAM_ADDR_MSB),
+        .P_SBRAM_MASK_MSB (P_SBRAM_MASK_MSB),
+        .P_SBRAM_HAS_FILE (P_SBRAM_HAS_FILE),
+        .P_SBRAM_INIT_FILE(P_SBRAM_INIT_FILE)
+      ) bank_mem_inst (
+        .i_ce   (i_ce   ),
+        .i_wclk (i_wclk ),
+        .i_rclk (i_rclk ),
+        .i_waddr(i_waddr),
+        .i_raddr(i_raddr),
+        .i_we   (i_we   ),
+        .i_mask (i_mask ), // 0=writes, 1=masks
+        .i_wdata(i_wdata),
+        .o_rdata(o_rdata)
+      );
+    end // single_bank_gen
+    else begin: multi_bank_gen
+      localparam integer L_BANK_SIZE = 2**(P_BANK_ADDR_MSB+1);
+      localparam integer L_BANKS     = (P_SBRAM_DEPTH+L_BANK_SIZE-1)/L_BANK_SIZE;
+      localparam integer L_SEL_MSB   = P_SBRAM_ADDR_MSB-P_BANK_ADDR_MSB-1;
+      // Bank outputs, bank 0 in the lowest bits
+      wire [(L_BANKS*L_WIDTH)-1:0] w_bank_rdata;
+      wire [L_SEL_MSB:0]           w_wr_sel = i_waddr[P_SBRAM_ADDR_MSB:P_BANK_ADDR_MSB+1];
+      reg  [L_SEL_MSB:0]           r_rd_sel;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  Read Bank Select Process
+      // Description : Follows the bank output registers, held with them while
+      //               the memory is not enabled.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_rclk) begin : rd_sel_proc
+        if (i_ce == 1'b1) begin
+          r_rd_sel <= i_raddr[P_SBRAM_ADDR_MSB:P_BANK_ADDR_MSB+1];
+        end
+      end // rd_sel_proc
+      //
+      assign o_rdata = w_bank_rdata[r_rd_sel*L_WIDTH +: L_WIDTH];
+
+      for (bank = 0; bank < L_BANKS; bank = bank+1) begin: bank_gen
+        wire w_bank_we = (i_we == 1'b1 && w_wr_sel == bank) ? 1'b1 : 1'b0;
+
+        ///////////////////////////////////////////////////////////////////////////////
+        // Instance    : Bank BRAM
+        // Description : Inferrable Single Port Block RAM.
+        ///////////////////////////////////////////////////////////////////////////////
+        generic_sbram #(
+          // Compile time configurable parameters
+          .P_SBRAM_DATA_MSB (P_SBRAM_DATA_MSB),
+          .P_SBRAM_ADDR_MSB (P_BANK_ADDR_MSB),
+          .P_SBRAM_MASK_MSB (P_SBRAM_MASK_MSB),
+          .P_SBRAM_HAS_FILE (0),
+          .P_SBRAM_INIT_FILE(0)
+        ) bank_mem_inst (
+          .i_ce   (i_ce                                 ),
+          .i_wclk (i_wclk                               ),
+          .i_rclk (i_rclk                               ),
+          .i_waddr(i_waddr[P_BANK_ADDR_MSB:0]           ),
+          .i_raddr(i_raddr[P_BANK_ADDR_MSB:0]           ),
+          .i_we   (w_bank_we                            ),
+          .i_mask (i_mask                               ), // 0=writes, 1=masks
+          .i_wdata(i_wdata                              ),
+          .o_rdata(w_bank_rdata[bank*L_WIDTH +: L_WIDTH])
+        );
+      end // bank_gen
+    end // multi_bank_gen
+  endgenerate
+
+endmodule // wb4_banked_sbram
@@ -21,13 +21,26 @@ Additional Comments:
 module wb4_dual_clock_fifo #(
   parameter integer P_DATA_I_MSB    = 7,            // FIFO Width-1
   parameter integer P_DATA_O_MSB    = P_DATA_I_MSB, // FIFO Width-1
-  parameter integer P_DEPTH         = 128,          // FIFO $clog2(Depth)-1
-  //parameter integer P_USE_BRAM      = 1,            // BRAM of LUT based
+  parameter integer P_DEPTH         = 128,          // FIFO Depth, power of 2 unless LUT or packet FIFO
+  parameter integer P_USE_BRAM      = 1,            // BRAM of LUT based, LUT on the 1 to 1 and gearbox FIFOs only
   parameter integer P_MASK_MSB      = P_DATA_O_MSB, // P_DATA_O_MSB=bit, (P_DATA_O_MSB+1)/4=nibble...
+  parameter integer P_SKID_BUFFER   = 0,            // 1=Registered STALL/DAT on both ports (N to 1 only)
+  parameter integer P_BANK_DEPTH    = 0,            // 0=One memory, else BRAM bank depth (packet FIFO only)
+  parameter integer P_NB_RESP       = 0,            // Full/empty strobes: 0=STALL, 1=RTY, 2=ERR
+  parameter integer P_STATS         = 0,            // 1=Statistics counters on the CSR port
+  parameter integer P_RD_PIPE_STAGES = 0,           // Extra registers on the read DAT/ACK/STALL
   // Write Synchronizers Params
   parameter integer P_WR_SYNC_DEPTH = 2,
   // Read Synchronizers Params
-  parameter integer P_RD_SYNC_DEPTH = 2 
+  parameter integer P_RD_SYNC_DEPTH = 2,
+  parameter integer P_CLK_MODE      = 0, // 0=Asynchronous clocks, 1=Related clocks (1 to 1 LUT only)
+  // Fill Level Params, in stored words (the wider of the two widths)
+  parameter integer P_ALMOST_FULL   = (P_DEPTH*3)/4, // Almost Full when level >= P_ALMOST_FULL
+  parameter integer P_ALMOST_EMPTY  = P_DEPTH/4,     // Almost Empty when level <= P_ALMOST_EMPTY
+  parameter integer P_PROG_THRESH   = 0,             // 1=Use the threshold input ports instead
+  // Packet Mode Params (1 to 1 only)
+  parameter integer P_PACKET        = 0, // 1=EOP/abort side band, commit/rollback write pointer
+  parameter integer P_CUT_THROUGH   = 0  // 0=Store-and-forward, 1=Cut-through
 )(
   // Write Interface  Signals
   input                   i_wb4_in_sclk,   // Cycle, not abort
@@ -37,6 +50,14 @@ module wb4_dual_clock_fifo #(
   output                  o_wb4_in_sack,   // Write Strobe
   input  [P_DATA_I_MSB:0] i_wb4_in_sdata,  // Write Data
   output                  o_wb4_in_sstall, // Full?
+  output                  o_wb4_in_serr,   // Written while full, P_NB_RESP=2
+  output                  o_wb4_in_srty,   // Written while full, P_NB_RESP=1
+  input                   i_wb4_in_seop,   // Last word of the frame, P_PACKET=1
+  input                   i_wb4_in_sabort, // Drop/flag the frame, P_PACKET=1
+  // Write Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Runtime threshold, P_PROG_THRESH=1
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
   // Read Interface Signals
   input                   i_wb4_out_sclk,   // Cycle, not abort
   input                   i_wb4_out_srst,   // reset
@@ -44,7 +65,24 @@ module wb4_dual_clock_fifo #(
   input                   i_wb4_out_sstb,   // Read Strobe
   output                  o_wb4_out_sack,   // Write Strobe
   output [P_DATA_O_MSB:0] o_wb4_out_sdata,  // Read Data
-  output                  o_wb4_out_sstall  // Empty?
+  output                  o_wb4_out_sstall, // Empty?
+  output                  o_wb4_out_seop,   // Last word of the frame, P_PACKET=1
+  output                  o_wb4_out_sabort, // Aborted frame, valid with ACK, P_PACKET=1
+  output                  o_wb4_out_serr,   // Read while empty, P_NB_RESP=2
+  output                  o_wb4_out_srty,   // Read while empty, P_NB_RESP=1
+  // Read Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Runtime threshold, P_PROG_THRESH=1
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level,         // Entries in use
+  // Statistics CSR Interface, P_STATS=1, write clock
+  input                   i_wb4_csr_scyc,   // Cycle
+  input                   i_wb4_csr_sstb,   // Strobe
+  input                   i_wb4_csr_swe,    // Write Enable
+  input  [2:0]            i_wb4_csr_sadr,   // Register
+  input  [31:0]           i_wb4_csr_sdata,  // Write Data
+  output                  o_wb4_csr_sack,   // Acknowledge
+  output [31:0]           o_wb4_csr_sdata,  // Read Data
+  output                  o_wb4_csr_sstall  // Never stalls
 );
 
 /*verilator coverage_off*/
@@ -58,14 +96,14 @@ module wb4_dual_clock_fifo #(
   //     and create reports.
   ///////////////////////////////////////////////////////////////////////////////
   initial begin
-    if(P_DATA_I_MSB > P_DATA_O_MSB) begin
-      $display("[COMPILE-ERROR]");
+    if(((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) != 0 && ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0) begin
+      $display("[COMPILE-NOTICE]");
       $display("  source: wb4_dual_clock_fifo");
-      $display("  type: Parameter");
+      $display("  type: Infered Logic");
       $display("  parameters:");
       $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
       $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
-      $display("  description: P_DATA_O_MSB can't be samller than P_DATA_I_MSB.");
+      $display("  description: The widths are not multiples of each other, generating a %0d to %0d gearbox FIFO.", P_DATA_I_MSB+1, P_DATA_O_MSB+1);
     end
 
     if(P_MASK_MSB > P_DATA_O_MSB) begin
@@ -78,19 +116,57 @@ module wb4_dual_clock_fifo #(
       $display("  description: P_DATA_O_MSB can't be samller than P_MASK_MSB.");
     end
 
-    // if(P_USE_BRAM == 0) begin
-    //   $display("<compile>");
-    //   $display("  <notice>");
-    //   $display("    <source>wb4_dual_clock_fifo</source>");
-    //   $display("    <type>Infered Logic</type>");
-    //   $display("    <parameter>P_USE_BRAM</parameter>");
-    //   $display("    <param_value>%0d</param_value>", P_USE_BRAM);
-    //   $display("    <description>Inferring LUTs instead of BRAM for FIFO space.</description>");
-    //   $display("  </notice>");
-    //   $display("</compile>");
-    // end
-
-    if(P_DATA_I_MSB < P_DATA_O_MSB) begin
+    if((P_DEPTH & (P_DEPTH-1)) != 0 && P_PACKET == 0 && (P_USE_BRAM == 1 || P_DATA_I_MSB != P_DATA_O_MSB)) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_DEPTH: %0d", P_DEPTH);
+      $display("    P_USE_BRAM: %0d", P_USE_BRAM);
+      $display("    P_PACKET: %0d", P_PACKET);
+      $display("  description: The cdc_lib FIFOs need a power of 2 P_DEPTH, other depths need the 1 to 1 LUT or the packet FIFO.");
+    end
+
+    if(P_NB_RESP > 2) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_NB_RESP: %0d", P_NB_RESP);
+      $display("  description: P_NB_RESP must be 0 (STALL), 1 (RTY) or 2 (ERR).");
+    end
+
+    if(P_USE_BRAM == 0 && P_PACKET == 0 && (P_DATA_I_MSB == P_DATA_O_MSB || (((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) != 0 && ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0))) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Infered Logic");
+      $display("  parameters:");
+      $display("    P_USE_BRAM: %0d", P_USE_BRAM);
+      $display("  description: Inferring LUTs instead of BRAM for FIFO space.");
+    end
+
+    if(P_USE_BRAM == 0 && (P_PACKET == 1 || (P_DATA_I_MSB != P_DATA_O_MSB && !(((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) != 0 && ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0)))) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_USE_BRAM: %0d", P_USE_BRAM);
+      $display("    P_PACKET: %0d", P_PACKET);
+      $display("  description: The LUT backend is only available on the 1 to 1 and gearbox FIFOs, using BRAM.");
+    end
+
+    if(P_SKID_BUFFER == 1 && (P_DATA_I_MSB >= P_DATA_O_MSB || ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0)) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_SKID_BUFFER: %0d", P_SKID_BUFFER);
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: The skid buffers are only available on the N to 1 FIFO, ignoring P_SKID_BUFFER.");
+    end
+
+    if(P_DATA_I_MSB < P_DATA_O_MSB && ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) == 0) begin
       $display("[COMPILE-NOTICE]");
       $display("  source: wb4_dual_clock_fifo");
       $display("  type: Infered Logic");
@@ -99,15 +175,234 @@ module wb4_dual_clock_fifo #(
       $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
       $display("  description: Generating an %0d to 1 FIFO.", ((P_DATA_O_MSB+1)/(P_DATA_I_MSB+1)));
     end
+
+    if(P_PACKET == 1 && P_DATA_I_MSB != P_DATA_O_MSB) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_PACKET: %0d", P_PACKET);
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: Packet mode is only available on the 1 to 1 FIFO, ignoring P_PACKET.");
+    end
+
+    if(P_CLK_MODE == 1 && (P_PACKET == 1 || P_DATA_I_MSB != P_DATA_O_MSB || P_USE_BRAM == 1)) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_CLK_MODE: %0d", P_CLK_MODE);
+      $display("    P_USE_BRAM: %0d", P_USE_BRAM);
+      $display("    P_PACKET: %0d", P_PACKET);
+      $display("  description: The related clock handoff is only available on the 1 to 1 LUT FIFO, the pointers go through the P_WR_SYNC_DEPTH/P_RD_SYNC_DEPTH synchronizers.");
+    end
+
+    if(P_BANK_DEPTH != 0 && (P_PACKET == 0 || P_DATA_I_MSB != P_DATA_O_MSB)) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_BANK_DEPTH: %0d", P_BANK_DEPTH);
+      $display("    P_PACKET: %0d", P_PACKET);
+      $display("  description: The other FIFOs keep their words in cdc_lib, only the packet FIFO is banked, ignoring P_BANK_DEPTH.");
+    end
+
+    if(P_DATA_I_MSB > P_DATA_O_MSB && ((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) == 0) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Infered Logic");
+      $display("  parameters:");
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: Generating a 1 to %0d FIFO.", ((P_DATA_I_MSB+1)/(P_DATA_O_MSB+1)));
+    end
+
+    if(P_RD_PIPE_STAGES != 0) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_dual_clock_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_RD_PIPE_STAGES: %0d", P_RD_PIPE_STAGES);
+      $display("  description: The read pipeline pops the FIFO ahead of the master. The words it prefetched are not in the level, the almost empty flag nor the statistics.");
+    end
   end
 /*verilator coverage_on*/
 
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_LEVEL_MSB = $clog2(P_DEPTH);
+  // Neither width a multiple of the other, see gearbox_fifo_gen.
+  localparam integer L_GEARBOX   = (((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) != 0 &&
+                                    ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0) ? 1 : 0;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Almost Full/Empty thresholds, compile time or runtime programmable.
+  wire [L_LEVEL_MSB:0] w_afull_thresh  = (P_PROG_THRESH == 1) ? i_wb4_in_afull_thresh   : P_ALMOST_FULL;
+  wire [L_LEVEL_MSB:0] w_aempty_thresh = (P_PROG_THRESH == 1) ? i_wb4_out_aempty_thresh : P_ALMOST_EMPTY;
+  // Master side strobes and FIFO side stalls, see nb_resp_gen.
+  wire w_in_stb;
+  wire w_in_stall;
+  wire w_out_stb;
+  wire w_out_stall;
+  wire w_out_nb_err;
+  wire w_frame_abort;
+  // FIFO read port, behind the read pipeline, see rd_pipe_gen.
+  wire                  w_fifo_rd_cyc;
+  wire                  w_fifo_rd_stb;
+  wire                  w_fifo_rd_ack;
+  wire [P_DATA_O_MSB:0] w_fifo_rd_data;
+  wire                  w_fifo_rd_stall;
+  wire                  w_fifo_rd_eop;
+  wire                  w_fifo_rd_abort;
+
   ///////////////////////////////////////////////////////////////////////////////
   //            ********      Architecture Declaration      ********           //
   ///////////////////////////////////////////////////////////////////////////////
-  
+
+  generate
+  if (P_NB_RESP == 0) begin: stall_resp_gen
+    // Full/empty stall the master.
+    assign w_in_stb         = i_wb4_in_sstb;
+    assign o_wb4_in_sstall  = w_in_stall;
+    assign o_wb4_in_serr    = 1'b0;
+    assign o_wb4_in_srty    = 1'b0;
+    assign w_out_stb        = i_wb4_out_sstb;
+    assign o_wb4_out_sstall = w_out_stall;
+    assign w_out_nb_err     = 1'b0;
+    assign o_wb4_out_srty   = 1'b0;
+  end // stall_resp_gen
+  else begin: nb_resp_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Write Port Response Control
+  // Description : A write to a full FIFO is terminated with RTY/ERR.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_resp_ctrl #(
+    .P_RESP(P_NB_RESP)
+  ) wr_resp_ctrl_inst (
+    .i_clk  (i_wb4_in_sclk  ),
+    .i_rst  (i_wb4_in_srst  ),
+    .i_cyc  (i_wb4_in_scyc  ),
+    .i_stb  (i_wb4_in_sstb  ),
+    .o_stall(o_wb4_in_sstall),
+    .o_err  (o_wb4_in_serr  ),
+    .o_rty  (o_wb4_in_srty  ),
+    .o_stb  (w_in_stb       ),
+    .i_stall(w_in_stall     ),
+    .i_ack  (o_wb4_in_sack  )
+  );
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Read Port Response Control
+  // Description : A read from an empty FIFO is terminated with RTY/ERR.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_resp_ctrl #(
+    .P_RESP(P_NB_RESP)
+  ) rd_resp_ctrl_inst (
+    .i_clk  (i_wb4_out_sclk  ),
+    .i_rst  (i_wb4_out_srst  ),
+    .i_cyc  (i_wb4_out_scyc  ),
+    .i_stb  (i_wb4_out_sstb  ),
+    .o_stall(o_wb4_out_sstall),
+    .o_err  (w_out_nb_err    ),
+    .o_rty  (o_wb4_out_srty  ),
+    .o_stb  (w_out_stb       ),
+    .i_stall(w_out_stall     ),
+    .i_ack  (o_wb4_out_sack  )
+  );
+  end // nb_resp_gen
+  endgenerate
+
   generate
-  if (P_DATA_I_MSB == P_DATA_O_MSB) begin: one_to_one_fifo_gen
+  if (P_RD_PIPE_STAGES == 0) begin: no_rd_pipe_gen
+    // The read port goes straight to the FIFO.
+    assign w_fifo_rd_cyc   = i_wb4_out_scyc;
+    assign w_fifo_rd_stb   = w_out_stb;
+    assign w_out_stall     = w_fifo_rd_stall;
+    assign o_wb4_out_sack  = w_fifo_rd_ack;
+    assign o_wb4_out_sdata = w_fifo_rd_data;
+    assign o_wb4_out_seop  = w_fifo_rd_eop;
+    assign w_frame_abort   = w_fifo_rd_abort;
+  end // no_rd_pipe_gen
+  else begin: rd_pipe_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Read Pipeline
+  // Description : P_RD_PIPE_STAGES registers on the read DAT/ACK, the buffer
+  //               pops the FIFO ahead of the master so STALL stays registered
+  //               and a word per clock goes through.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_rd_skid_buffer #(
+    .P_DATA_MSB   (P_DATA_O_MSB+2),
+    .P_PIPE_STAGES(P_RD_PIPE_STAGES)
+  ) rd_pipe_inst (
+    .i_clk   (i_wb4_out_sclk                                   ),
+    .i_rst   (i_wb4_out_srst                                   ),
+    // Master Side
+    .i_cyc   (i_wb4_out_scyc                                   ),
+    .i_stb   (w_out_stb                                        ),
+    .o_ack   (o_wb4_out_sack                                   ),
+    .o_data  ({o_wb4_out_seop, w_frame_abort, o_wb4_out_sdata} ),
+    .o_stall (w_out_stall                                      ),
+    // FIFO Side
+    .o_cyc   (w_fifo_rd_cyc                                    ),
+    .o_stb   (w_fifo_rd_stb                                    ),
+    .i_accept(w_fifo_rd_stb & ~w_fifo_rd_stall                 ),
+    .i_ack   (w_fifo_rd_ack                                    ),
+    .i_data  ({w_fifo_rd_eop, w_fifo_rd_abort, w_fifo_rd_data} )
+  );
+  end // rd_pipe_gen
+  endgenerate
+
+  generate
+  if (P_STATS == 1) begin: stats_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : FIFO Statistics
+  // Description : Counters behind the CSR port, on the write clock.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_fifo_stats #(
+    .P_LEVEL_MSB (L_LEVEL_MSB),
+    .P_SYNC_DEPTH(P_RD_SYNC_DEPTH)
+  ) wb4_fifo_stats_inst (
+    // Write Domain
+    .i_wr_clk    (i_wb4_in_sclk                                     ),
+    .i_wr_rst    (i_wb4_in_srst                                     ),
+    .i_wr_accept (i_wb4_in_scyc & w_in_stb & ~w_in_stall            ),
+    .i_wr_stall  (i_wb4_in_scyc & i_wb4_in_sstb & o_wb4_in_sstall   ),
+    .i_wr_refused(o_wb4_in_serr | o_wb4_in_srty                     ),
+    .i_wr_level  (o_wb4_in_level                                    ),
+    // Read Domain
+    .i_rd_clk    (i_wb4_out_sclk                                    ),
+    .i_rd_rst    (i_wb4_out_srst                                    ),
+    .i_rd_accept (i_wb4_out_scyc & w_out_stb & ~w_out_stall         ),
+    .i_rd_stall  (i_wb4_out_scyc & i_wb4_out_sstb & o_wb4_out_sstall),
+    .i_rd_refused(w_out_nb_err | o_wb4_out_srty                     ),
+    // CSR Slave Interface
+    .i_csr_cyc   (i_wb4_csr_scyc                                    ),
+    .i_csr_stb   (i_wb4_csr_sstb                                    ),
+    .i_csr_we    (i_wb4_csr_swe                                     ),
+    .i_csr_adr   (i_wb4_csr_sadr                                    ),
+    .i_csr_data  (i_wb4_csr_sdata                                   ),
+    .o_csr_ack   (o_wb4_csr_sack                                    ),
+    .o_csr_data  (o_wb4_csr_sdata                                   ),
+    .o_csr_stall (o_wb4_csr_sstall                                  )
+  );
+  end // stats_gen
+  else begin: no_stats_gen
+    assign o_wb4_csr_sack   = 1'b0;
+    assign o_wb4_csr_sdata  = 32'h0;
+    assign o_wb4_csr_sstall = 1'b0;
+  end // no_stats_gen
+  endgenerate
+
+  // ERR only ends a refused read, an aborted frame word comes with ACK.
+  assign o_wb4_out_serr   = w_out_nb_err;
+  assign o_wb4_out_sabort = w_frame_abort;
+
+  generate
+  if (P_DATA_I_MSB == P_DATA_O_MSB && P_PACKET == 0) begin: one_to_one_fifo_gen
   ///////////////////////////////////////////////////////////////////////////////
   // Instance    : WB4 Sync 1 to 1 FIFO
   // Description : 
@@ -115,33 +410,97 @@ module wb4_dual_clock_fifo #(
   wb4_dual_clock_fifo_1_to_1 #(
     .P_DATA_MSB(P_DATA_I_MSB), // FIFO Width-1
     .P_DEPTH   (P_DEPTH     ), // FIFO $clog2(Depth)-1
-    //.P_USE_BRAM(P_USE_BRAM  ), // BRAM of LUT based
+    .P_USE_BRAM(P_USE_BRAM  ), // BRAM of LUT based
     // CDC Params
     .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH),
-    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH),
+    .P_CLK_MODE     (P_CLK_MODE     )
   ) wb4_dual_clock_fifo_1_to_1_inst (
     // Write Interface  Signals
     .i_wb4_in_sclk  (i_wb4_in_sclk  ), //
     .i_wb4_in_srst  (i_wb4_in_srst  ), //
     .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
-    .i_wb4_in_sstb  (i_wb4_in_sstb  ), // Write Strobe
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
     .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
     .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
-    .o_wb4_in_sstall(o_wb4_in_sstall), // Full?
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
     // Read Interface Signals
     .i_wb4_out_sclk  (i_wb4_out_sclk  ), // 
     .i_wb4_out_srst  (i_wb4_out_srst  ), //
-    .i_wb4_out_scyc  (i_wb4_out_scyc  ), // Not Abort / Enable
-    .i_wb4_out_sstb  (i_wb4_out_sstb  ), // Read Strobe
-    .o_wb4_out_sack  (o_wb4_out_sack  ), // Read Acknowledge
-    .o_wb4_out_sdata (o_wb4_out_sdata ), // Read Data
-    .o_wb4_out_sstall(o_wb4_out_sstall)  // Empty?
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
   );
   end  // one_to_one_fifo_gen
   endgenerate
 
   generate
-  if (P_DATA_I_MSB < P_DATA_O_MSB) begin: N_to_one_fifo_gen
+  if (P_DATA_I_MSB == P_DATA_O_MSB && P_PACKET == 1) begin: packet_fifo_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Dual Clock Packet FIFO
+  // Description : 1 to 1 FIFO with frame commit/rollback.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_dual_clock_fifo_packet #(
+    .P_DATA_MSB   (P_DATA_I_MSB ), // FIFO Width-1
+    .P_DEPTH      (P_DEPTH      ), // FIFO $clog2(Depth)-1
+    .P_CUT_THROUGH(P_CUT_THROUGH), // Store-and-forward or cut-through
+    .P_BANK_DEPTH (P_BANK_DEPTH ), // BRAM bank depth
+    // CDC Params
+    .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH),
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)
+  ) wb4_dual_clock_fifo_packet_inst (
+    // Write Interface  Signals
+    .i_wb4_in_sclk  (i_wb4_in_sclk  ), //
+    .i_wb4_in_srst  (i_wb4_in_srst  ), //
+    .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
+    .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
+    .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    .i_wb4_in_seop  (i_wb4_in_seop  ), // End of Packet
+    .i_wb4_in_sabort(i_wb4_in_sabort), // Drop/flag the frame
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
+    // Read Interface Signals
+    .i_wb4_out_sclk  (i_wb4_out_sclk  ), // 
+    .i_wb4_out_srst  (i_wb4_out_srst  ), //
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    .o_wb4_out_seop  (w_fifo_rd_eop   ), // End of Packet
+    .o_wb4_out_sabort(w_fifo_rd_abort ), // Aborted frame
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
+  );
+  end  // packet_fifo_gen
+  endgenerate
+
+  generate
+  if (P_DATA_I_MSB != P_DATA_O_MSB || P_PACKET == 0) begin: no_packet_gen
+    // No frame side band out of the non packet FIFOs.
+    assign w_fifo_rd_eop  = 1'b0;
+    assign w_fifo_rd_abort = 1'b0;
+  end // no_packet_gen
+  endgenerate
+
+  generate
+  if (P_DATA_I_MSB < P_DATA_O_MSB && L_GEARBOX == 0) begin: N_to_one_fifo_gen
   ///////////////////////////////////////////////////////////////////////////////
   // Instance    : WB4 Sync 1 to 1 FIFO
   // Description : 
@@ -150,8 +509,8 @@ module wb4_dual_clock_fifo #(
     .P_DATA_I_MSB(P_DATA_I_MSB), // FIFO Width-1
     .P_DATA_O_MSB(P_DATA_O_MSB), // FIFO Width-1
     .P_DEPTH     (P_DEPTH     ), // FIFO $clog2(Depth)-1
-    //.P_USE_BRAM  (1           ), // BRAM of LUT based
     .P_MASK_MSB  (P_MASK_MSB  ), // 
+    .P_SKID_BUFFER(P_SKID_BUFFER), // Registered STALL/DAT
     // CDC Params
     .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH),
     .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)
@@ -160,20 +519,113 @@ module wb4_dual_clock_fifo #(
     .i_wb4_in_sclk  (i_wb4_in_sclk  ), // 
     .i_wb4_in_srst  (i_wb4_in_srst  ),
     .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
-    .i_wb4_in_sstb  (i_wb4_in_sstb  ), // Write Strobe
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
     .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
     .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
-    .o_wb4_in_sstall(o_wb4_in_sstall), // Full?
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
     // Read Interface Signals
     .i_wb4_out_sclk  (i_wb4_out_sclk  ), //
     .i_wb4_out_srst  (i_wb4_out_srst  ), //
-    .i_wb4_out_scyc  (i_wb4_out_scyc  ), // Not Abort / Enable
-    .i_wb4_out_sstb  (i_wb4_out_sstb  ), // Read Strobe
-    .o_wb4_out_sack  (o_wb4_out_sack  ), // Read Acknowledge
-    .o_wb4_out_sdata (o_wb4_out_sdata ), // Read Data
-    .o_wb4_out_sstall(o_wb4_out_sstall)  // Empty?
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
   );
   end // N_to_one_fifo_gen
   endgenerate
 
+  generate
+  if (P_DATA_I_MSB > P_DATA_O_MSB && L_GEARBOX == 0) begin: one_to_N_fifo_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Dual Clock 1 to N FIFO
+  // Description : Wide input words, narrow output sub-words.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_dual_clock_fifo_1_to_N #(
+    .P_DATA_I_MSB(P_DATA_I_MSB), // FIFO Width-1
+    .P_DATA_O_MSB(P_DATA_O_MSB), // FIFO Width-1
+    .P_DEPTH     (P_DEPTH     ), // FIFO Depth in input words
+    // CDC Params
+    .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH),
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)
+  ) wb4_dual_clock_fifo_1_to_N_inst (
+    // Write Interface  Signals
+    .i_wb4_in_sclk  (i_wb4_in_sclk  ), // 
+    .i_wb4_in_srst  (i_wb4_in_srst  ),
+    .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
+    .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
+    .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
+    // Read Interface Signals
+    .i_wb4_out_sclk  (i_wb4_out_sclk  ), //
+    .i_wb4_out_srst  (i_wb4_out_srst  ), //
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
+  );
+  end // one_to_N_fifo_gen
+  endgenerate
+
+  generate
+  if (L_GEARBOX == 1) begin: gearbox_fifo_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Dual Clock Gearbox FIFO
+  // Description : Any input and output widths, e.g. 24 to 32 or 10 to 8.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_dual_clock_fifo_gearbox #(
+    .P_DATA_I_MSB(P_DATA_I_MSB), // FIFO Width-1
+    .P_DATA_O_MSB(P_DATA_O_MSB), // FIFO Width-1
+    .P_DEPTH     (P_DEPTH     ), // FIFO Depth in stored (wider) words
+    .P_USE_BRAM  (P_USE_BRAM  ), // BRAM of LUT based
+    // CDC Params
+    .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH),
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)
+  ) wb4_dual_clock_fifo_gearbox_inst (
+    // Write Interface  Signals
+    .i_wb4_in_sclk  (i_wb4_in_sclk  ), // 
+    .i_wb4_in_srst  (i_wb4_in_srst  ),
+    .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
+    .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
+    .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
+    // Read Interface Signals
+    .i_wb4_out_sclk  (i_wb4_out_sclk  ), //
+    .i_wb4_out_srst  (i_wb4_out_srst  ), //
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
+  );
+  end // gearbox_fifo_gen
+  endgenerate
+
 endmodule // wb4_dual_clock_fifo
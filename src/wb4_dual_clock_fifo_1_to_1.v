@@ -16,11 +16,34 @@ Module Name  : wb4_dual_clock_fifo_1_to_1
 Description  : Wishbone B4(pipelined) dual clock FIFO One-to-One data units 
 
 Additional Comments:
-   
+   P_USE_BRAM=1 uses the cdc_lib dual_clock_fifo (block RAM).
+   P_USE_BRAM=0 keeps the words in distributed (LUT) RAM with its own gray
+   coded pointers, meant for shallow FIFOs (8 to 32 entries) that should not
+   use up a block RAM. The LUT is read asynchronously and captured on the pop
+   edge, so the data comes with the ack one clock after the strobe, the same
+   as the BRAM backend. The full/empty latency is set by the synchronizers in
+   both cases.
+   The LUT backend takes any P_DEPTH: the gray coded pointers keep their
+   natural binary wrap and the memory index is a separate modulo P_DEPTH
+   count in each domain. The cdc_lib FIFO needs a power of 2.
+   A write is readable (and a read frees its slot) P_RD_SYNC_DEPTH
+   (P_WR_SYNC_DEPTH) destination clocks after it, plus the phase to the
+   first destination edge. Clocks from the same PLL at a known ratio can run
+   with both set to 1 as long as the crossing is then timed as a synchronous
+   path between the related clocks, not cut as a false path.
+   P_CLK_MODE=1 (related clocks, LUT backend) drops the synchronizers: each
+   domain compares against the other domain's gray pointer register as is,
+   so a write can be read on the first read edge after its write edge, the
+   read level rising on that edge too (and a read frees its slot on the
+   first write edge after it). Both clocks must come from the same PLL with
+   the crossing timed as a synchronous path, STA then checks the closest
+   edge pair of the ratio. The BRAM backend keeps its synchronizers.
 */
 module wb4_dual_clock_fifo_1_to_1 #(
   parameter integer P_DATA_MSB = 7,   // FIFO Width-1
-  parameter integer P_DEPTH    = 128, // FIFO $clog2(Depth)-1
+  parameter integer P_DEPTH    = 128, // FIFO Depth, power of 2 with the BRAM
+  parameter integer P_USE_BRAM = 1,   // BRAM of LUT based
+  parameter integer P_CLK_MODE = 0,   // 0=Asynchronous clocks, 1=Related clocks (LUT only)
   // Write Synchronizers Params
   parameter integer P_WR_SYNC_DEPTH = 2, //
   // Read Synchronizers Params
@@ -34,6 +57,10 @@ module wb4_dual_clock_fifo_1_to_1 #(
   output                o_wb4_in_sack,   // Write Strobe
   input  [P_DATA_MSB:0] i_wb4_in_sdata,  // Write Data
   output                o_wb4_in_sstall, // Full?
+  // Write Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
   // Read Interface Signals 
   input                 i_wb4_out_sclk,   //
   input                 i_wb4_out_srst,   //
@@ -41,13 +68,23 @@ module wb4_dual_clock_fifo_1_to_1 #(
   input                 i_wb4_out_sstb,   // Read Strobe
   output                o_wb4_out_sack,   // Write Strobe
   output [P_DATA_MSB:0] o_wb4_out_sdata,  // Read Data
-  output                o_wb4_out_sstall  // Empty?
+  output                o_wb4_out_sstall, // Empty?
+  // Read Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level          // Entries in use
 );
 
   ///////////////////////////////////////////////////////////////////////////////
   // Internal Parameter Declarations
   ///////////////////////////////////////////////////////////////////////////////
   localparam L_ADDR_MSB = $clog2(P_DEPTH)-1;
+  // The LUT backend pointers carry one extra wrap bit.
+  localparam L_PTR_MSB  = L_ADDR_MSB+1;
+  localparam L_PTR_PAD  = L_PTR_MSB;
+  localparam L_POW2     = ((P_DEPTH & (P_DEPTH-1)) == 0) ? 1 : 0;
+  // Pointers handed over without synchronizers, see P_CLK_MODE.
+  localparam L_RELATED  = (P_CLK_MODE == 1 && P_USE_BRAM == 0) ? 1 : 0;
 
   ///////////////////////////////////////////////////////////////////////////////
   // Internal Signals Declarations
@@ -63,6 +100,39 @@ module wb4_dual_clock_fifo_1_to_1 #(
   wire w_last;
   wire w_re = i_wb4_out_scyc & i_wb4_out_sstb & ~w_last;
 
+  ///////////////////////////////////////////////////////////////////////////////
+  // Function    : Gray to Binary
+  // Description :
+  ///////////////////////////////////////////////////////////////////////////////
+  function [L_PTR_MSB:0] gray2bin;
+    input [L_PTR_MSB:0] gray;
+    integer bit_idx;
+    begin
+      gray2bin[L_PTR_MSB] = gray[L_PTR_MSB];
+      for (bit_idx = L_PTR_MSB-1; bit_idx >= 0; bit_idx = bit_idx-1) begin
+        gray2bin[bit_idx] = gray2bin[bit_idx+1] ^ gray[bit_idx];
+      end
+    end
+  endfunction
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Function    : Modulo Address Increment
+  // Description : Wraps at P_DEPTH, the natural binary wrap with a power of 2
+  //               depth.
+  ///////////////////////////////////////////////////////////////////////////////
+  function [L_ADDR_MSB:0] addr_inc;
+    input [L_ADDR_MSB:0] addr;
+    input                inc;
+    begin
+      if (L_POW2 == 1 || addr != P_DEPTH-1) begin
+        addr_inc = addr + {{L_ADDR_MSB{1'b0}}, {inc}};
+      end
+      else begin
+        addr_inc = (inc == 1'b1) ? {(L_ADDR_MSB+1){1'b0}} : addr;
+      end
+    end
+  endfunction
+
   ///////////////////////////////////////////////////////////////////////////////
   //            ********      Architecture Declaration      ********           //
   ///////////////////////////////////////////////////////////////////////////////
@@ -76,13 +146,7 @@ module wb4_dual_clock_fifo_1_to_1 #(
       r_write_ack <= 1'b0;
     end
     else begin
-      if(w_full == 1'b0) begin
-        // 
-        r_write_ack <= i_wb4_in_sstb;
-      end
-      else begin
-        r_write_ack <= 1'b0;
-      end
+      r_write_ack <= w_we;
     end
   end // write_ack_proc
   //
@@ -90,31 +154,158 @@ module wb4_dual_clock_fifo_1_to_1 #(
   assign o_wb4_in_sstall  = w_full;
   assign o_wb4_out_sstall = w_last;
 
+  generate
+    if (P_USE_BRAM == 1) begin: bram_fifo_gen
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Dual Clock FIFO
+      // Description : 
+      ///////////////////////////////////////////////////////////////////////////////
+      dual_clock_fifo #(
+        // FIFO Params
+        .P_DATA_MSB(P_DATA_MSB), // FIFO Width-1
+        .P_DEPTH   (P_DEPTH),    // FIFO $clog2(Depth)-1
+        // Write Synchronizers Params
+        .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH), //
+        // Read Synchronizers Params
+        .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH) //
+      ) dual_clock_fifo_inst (
+        //
+        .i_wr_clk  (i_wb4_in_sclk),   //
+        .i_wr_rst  (i_wb4_in_srst),   //
+        .i_wr_inc  (w_we),            //
+        .i_wr_data (i_wb4_in_sdata),  // 
+        .o_wr_full (w_full),          // 
+        //
+        .i_rd_clk  (i_wb4_out_sclk),   //
+        .i_rd_rst  (i_wb4_out_srst),   //
+        .i_rd_inc  (w_re),             //
+        .o_rd_data (o_wb4_out_sdata),  //
+        .o_rd_empty(w_last)           //
+      );
+    end // bram_fifo_gen
+    else begin: lut_fifo_gen
+      // Mem Block
+      reg [P_DATA_MSB:0] mem [0:P_DEPTH-1] /*verilator public*/;
+      reg [P_DATA_MSB:0] r_lut_data;
+      // Write Domain
+      reg [L_PTR_MSB:0] r_wr_ptr;
+      reg [L_ADDR_MSB:0] r_wr_addr; // Memory index of r_wr_ptr
+      reg [L_PTR_MSB:0] r_wr_gray;
+      reg [L_PTR_MSB:0] r_rd_gray_sync [0:P_WR_SYNC_DEPTH-1];
+      // Read Domain
+      reg [L_PTR_MSB:0] r_rd_ptr;
+      reg [L_ADDR_MSB:0] r_rd_addr; // Memory index of r_rd_ptr
+      reg [L_PTR_MSB:0] r_rd_gray;
+      reg [L_PTR_MSB:0] r_wr_gray_sync [0:P_RD_SYNC_DEPTH-1];
+      //
+      integer wr_stage;
+      integer rd_stage;
+      //
+      wire [L_PTR_MSB:0] w_wr_ptr_next = r_wr_ptr + {{L_PTR_PAD{1'b0}}, {w_we}};
+      wire [L_PTR_MSB:0] w_rd_ptr_next = r_rd_ptr + {{L_PTR_PAD{1'b0}}, {w_re}};
+      wire [L_PTR_MSB:0] w_rd_gray_cdc = (L_RELATED == 1) ? r_rd_gray : r_rd_gray_sync[P_WR_SYNC_DEPTH-1];
+      wire [L_PTR_MSB:0] w_wr_gray_cdc = (L_RELATED == 1) ? r_wr_gray : r_wr_gray_sync[P_RD_SYNC_DEPTH-1];
+      wire [L_PTR_MSB:0] w_rd_ptr_sync = gray2bin(w_rd_gray_cdc);
+      // Sized so the difference wraps with the pointers.
+      wire [L_PTR_MSB:0] w_wr_used     = r_wr_ptr - w_rd_ptr_sync;
+
+      assign w_full = (w_wr_used == P_DEPTH) ? 1'b1 : 1'b0;
+      assign w_last = (r_rd_gray == w_wr_gray_cdc) ? 1'b1 : 1'b0;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  LUT Write Pointer Process
+      // Description : Write pointer, its gray copy and the read pointer
+      //               synchronizer.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_wb4_in_sclk) begin : lut_write_ptr_proc
+        if (i_wb4_in_srst == 1'b1) begin
+          r_wr_ptr  <= 'h0;
+          r_wr_addr <= 'h0;
+          r_wr_gray <= 'h0;
+          for (wr_stage = 0; wr_stage < P_WR_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+            r_rd_gray_sync[wr_stage] <= 'h0;
+          end
+        end
+        else begin
+          r_wr_ptr  <= w_wr_ptr_next;
+          r_wr_addr <= addr_inc(r_wr_addr, w_we);
+          r_wr_gray <= w_wr_ptr_next ^ (w_wr_ptr_next >> 1);
+          r_rd_gray_sync[0] <= r_rd_gray;
+          for (wr_stage = 1; wr_stage < P_WR_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+            r_rd_gray_sync[wr_stage] <= r_rd_gray_sync[wr_stage-1];
+          end
+        end
+      end // lut_write_ptr_proc
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  LUT Write Process
+      // Description : .
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_wb4_in_sclk) begin : lut_write_proc
+        if (w_we == 1'b1) begin
+          mem[r_wr_addr] <= i_wb4_in_sdata;
+        end
+      end // lut_write_proc
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  LUT Read Pointer Process
+      // Description : Read pointer, its gray copy and the write pointer
+      //               synchronizer. The asynchronous LUT read is captured on
+      //               the pop edge, the word was written before its pointer
+      //               crossed the synchronizer.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_wb4_out_sclk) begin : lut_read_ptr_proc
+        if (i_wb4_out_srst == 1'b1) begin
+          r_rd_ptr   <= 'h0;
+          r_rd_addr  <= 'h0;
+          r_rd_gray  <= 'h0;
+          r_lut_data <= 0;
+          for (rd_stage = 0; rd_stage < P_RD_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+            r_wr_gray_sync[rd_stage] <= 'h0;
+          end
+        end
+        else begin
+          r_rd_ptr  <= w_rd_ptr_next;
+          r_rd_addr <= addr_inc(r_rd_addr, w_re);
+          r_rd_gray <= w_rd_ptr_next ^ (w_rd_ptr_next >> 1);
+          if (w_re == 1'b1) begin
+            r_lut_data <= mem[r_rd_addr];
+          end
+          r_wr_gray_sync[0] <= r_wr_gray;
+          for (rd_stage = 1; rd_stage < P_RD_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+            r_wr_gray_sync[rd_stage] <= r_wr_gray_sync[rd_stage-1];
+          end
+        end
+      end // lut_read_ptr_proc
+      //
+      assign o_wb4_out_sdata = r_lut_data;
+    end // lut_fifo_gen
+  endgenerate
+
   ///////////////////////////////////////////////////////////////////////////////
-  // Instance    : Dual Clock FIFO
-  // Description : 
+  // Instance    : Fill Level
+  // Description : Level and almost full/empty flags in each clock domain.
   ///////////////////////////////////////////////////////////////////////////////
-  dual_clock_fifo #(
-    // FIFO Params
-    .P_DATA_MSB(P_DATA_MSB), // FIFO Width-1
-    .P_DEPTH   (P_DEPTH),    // FIFO $clog2(Depth)-1
-    // Write Synchronizers Params
+  wb4_dual_clock_fifo_level #(
+    .P_DEPTH        (P_DEPTH),         //
+    .P_CLK_MODE     (L_RELATED),       //
     .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH), //
-    // Read Synchronizers Params
-    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH) //
-  ) dual_clock_fifo_inst (
-    //
-    .i_wr_clk  (i_wb4_in_sclk),   //
-    .i_wr_rst  (i_wb4_in_srst),   //
-    .i_wr_inc  (w_we),            //
-    .i_wr_data (i_wb4_in_sdata),  // 
-    .o_wr_full (w_full),          // 
-    //
-    .i_rd_clk  (i_wb4_out_sclk),   //
-    .i_rd_rst  (i_wb4_out_srst),   //
-    .i_rd_inc  (w_re),             //
-    .o_rd_data (o_wb4_out_sdata),  //
-    .o_rd_empty(w_last)           //
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)  //
+  ) fifo_level_inst (
+    // Write
+    .i_wr_clk         (i_wb4_in_sclk),         //
+    .i_wr_rst         (i_wb4_in_srst),         //
+    .i_wr_inc         (w_we),                  //
+    .i_wr_afull_thresh(i_wb4_in_afull_thresh), //
+    .o_wr_almost_full (o_wb4_in_almost_full),  //
+    .o_wr_level       (o_wb4_in_level),        //
+    // Read
+    .i_rd_clk          (i_wb4_out_sclk),          //
+    .i_rd_rst          (i_wb4_out_srst),          //
+    .i_rd_inc          (w_re),                    //
+    .i_rd_aempty_thresh(i_wb4_out_aempty_thresh), //
+    .o_rd_almost_empty (o_wb4_out_almost_empty),  //
+    .o_rd_level        (o_wb4_out_level)          //
   );
 
   /////////////////////////////////////////////////////////////////////////////
@@ -126,13 +317,7 @@ module wb4_dual_clock_fifo_1_to_1 #(
       r_read_ack <= 1'b0;
     end
     else begin
-      if(w_last == 1'b0) begin
-        // 
-        r_read_ack <= i_wb4_out_sstb;
-      end
-      else begin
-        r_read_ack <= 1'b0;
-      end
+      r_read_ack <= w_re;
     end
   end // read_ack_proc
   // 
@@ -0,0 +1,228 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_dual_clock_fifo_1_to_N.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_dual_clock_fifo_1_to_N
+Description  : Wishbone B4(pipelined) dual clock FIFO One-to-Many data units
+
+Additional Comments:
+   The wide words cross the clock domains in a dual_clock_fifo. On the read
+   side a head register is unpacked, least significant sub-word first, while
+   the following word is prefetched into a staging register, so the narrow
+   sub-words come out one per read clock. The read side level only counts the
+   words still in the dual_clock_fifo.
+*/
+module wb4_dual_clock_fifo_1_to_N #(
+  // FIFO Params
+  parameter integer P_DATA_I_MSB = 31,  // FIFO Width-1
+  parameter integer P_DATA_O_MSB = 7,   // FIFO Width-1
+  parameter integer P_DEPTH      = 128, // FIFO Depth in input words
+  // Write Synchronizers Params
+  parameter integer P_WR_SYNC_DEPTH = 2, //
+  // Read Synchronizers Params
+  parameter integer P_RD_SYNC_DEPTH = 2  //
+)(
+  // Write Interface  Signals
+  input                   i_wb4_in_sclk,   //
+  input                   i_wb4_in_srst,   //
+  input                   i_wb4_in_scyc,   // Enable
+  input                   i_wb4_in_sstb,   // Write Strobe
+  output                  o_wb4_in_sack,   // Write Strobe
+  input  [P_DATA_I_MSB:0] i_wb4_in_sdata,  // Write Data
+  output                  o_wb4_in_sstall, // Full?
+  // Write Side Fill Level (in input words)
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
+  // Read Interface Signals
+  input                   i_wb4_out_sclk,   //
+  input                   i_wb4_out_srst,   //
+  input                   i_wb4_out_scyc,   // Read Cycle, Abort
+  input                   i_wb4_out_sstb,   // Read Strobe
+  output                  o_wb4_out_sack,   // Write Strobe
+  output [P_DATA_O_MSB:0] o_wb4_out_sdata,  // Read Data
+  output                  o_wb4_out_sstall, // Empty?
+  // Read Side Fill Level (in input words)
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level          // Entries in use
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam L_ADDR_MSB     = $clog2(P_DEPTH)-1;
+  localparam L_DATA_O_REPLI = (P_DATA_I_MSB+1)/(P_DATA_O_MSB+1);
+  localparam L_DATA_O_WIDTH = P_DATA_O_MSB+1;
+  localparam L_UNIT_MSB     = (L_DATA_O_REPLI > 1) ? $clog2(L_DATA_O_REPLI)-1 : 0;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Write Proc
+  reg r_write_ack;
+  // Read Proc
+  reg                   r_read_ack;
+  reg  [P_DATA_O_MSB:0] r_read_data;
+  // Unpacker
+  reg  [P_DATA_I_MSB:0] r_head_data;  // Word being unpacked
+  reg                   r_head_valid; //
+  reg  [L_UNIT_MSB:0]   r_unit_cnt;   // Sub-words already popped from the head word
+  reg  [P_DATA_I_MSB:0] r_next_data;  // Prefetched word
+  reg                   r_next_valid; //
+  reg                   r_fetch_pend; // dual_clock_fifo read data arrives this clock
+  wire [P_DATA_I_MSB:0] w_fetch_data;
+  // Write Controls Asynch Logic
+  wire w_full;
+  wire w_we = i_wb4_in_scyc & i_wb4_in_sstb & ~w_full;
+  // Read Controls Asynch Logic
+  wire w_empty;
+  wire w_re       = i_wb4_out_scyc & i_wb4_out_sstb & r_head_valid;
+  wire w_word_pop = w_re && (r_unit_cnt == L_DATA_O_REPLI-1);
+  // One word in flight at a time, only fetched when it has a place to land.
+  wire w_fetch    = ~w_empty & ~r_fetch_pend & ~r_next_valid;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write ACK Process
+  // Description :
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_in_sclk) begin : write_ack_proc
+    if (i_wb4_in_srst == 1'b1 || i_wb4_in_scyc == 1'b0) begin
+      r_write_ack <= 1'b0;
+    end
+    else begin
+      r_write_ack <= w_we;
+    end
+  end // write_ack_proc
+  //
+  assign o_wb4_in_sack    = r_write_ack;
+  assign o_wb4_in_sstall  = w_full;
+  assign o_wb4_out_sstall = ~r_head_valid;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Dual Clock FIFO
+  // Description : Carries the wide words across the clock domains.
+  ///////////////////////////////////////////////////////////////////////////////
+  dual_clock_fifo #(
+    // FIFO Params
+    .P_DATA_MSB(P_DATA_I_MSB), // FIFO Width-1
+    .P_DEPTH   (P_DEPTH),      // FIFO $clog2(Depth)-1
+    // Write Synchronizers Params
+    .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH), //
+    // Read Synchronizers Params
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH) //
+  ) dual_clock_fifo_inst (
+    //
+    .i_wr_clk  (i_wb4_in_sclk),   //
+    .i_wr_rst  (i_wb4_in_srst),   //
+    .i_wr_inc  (w_we),            //
+    .i_wr_data (i_wb4_in_sdata),  //
+    .o_wr_full (w_full),          //
+    //
+    .i_rd_clk  (i_wb4_out_sclk),  //
+    .i_rd_rst  (i_wb4_out_srst),  //
+    .i_rd_inc  (w_fetch),         //
+    .o_rd_data (w_fetch_data),    //
+    .o_rd_empty(w_empty)          //
+  );
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Unpack Process
+  // Description : Moves the prefetched word into the head register when the
+  //               last sub-word of the head is popped. A fetched word lands
+  //               in the head register if it is free, else in the staging one.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_out_sclk) begin : unpack_proc
+    if (i_wb4_out_srst == 1'b1) begin
+      r_head_data  <= 0;
+      r_head_valid <= 1'b0;
+      r_unit_cnt   <= 'h0;
+      r_next_data  <= 0;
+      r_next_valid <= 1'b0;
+      r_fetch_pend <= 1'b0;
+    end
+    else begin
+      r_fetch_pend <= w_fetch;
+      //
+      if (w_re == 1'b1) begin
+        r_unit_cnt <= (w_word_pop == 1'b1) ? 'h0 : r_unit_cnt + 1;
+      end
+      //
+      if (r_head_valid == 1'b0 || w_word_pop == 1'b1) begin
+        if (r_next_valid == 1'b1) begin
+          r_head_data  <= r_next_data;
+          r_head_valid <= 1'b1;
+          r_next_valid <= 1'b0;
+        end
+        else begin
+          r_head_data  <= w_fetch_data;
+          r_head_valid <= r_fetch_pend;
+        end
+      end
+      else if (r_fetch_pend == 1'b1) begin
+        r_next_data  <= w_fetch_data;
+        r_next_valid <= 1'b1;
+      end
+    end
+  end // unpack_proc
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Fill Level
+  // Description : Level and almost full/empty flags in each clock domain.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_dual_clock_fifo_level #(
+    .P_DEPTH        (P_DEPTH),         //
+    .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH), //
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)  //
+  ) fifo_level_inst (
+    // Write
+    .i_wr_clk         (i_wb4_in_sclk),         //
+    .i_wr_rst         (i_wb4_in_srst),         //
+    .i_wr_inc         (w_we),                  //
+    .i_wr_afull_thresh(i_wb4_in_afull_thresh), //
+    .o_wr_almost_full (o_wb4_in_almost_full),  //
+    .o_wr_level       (o_wb4_in_level),        //
+    // Read
+    .i_rd_clk          (i_wb4_out_sclk),          //
+    .i_rd_rst          (i_wb4_out_srst),          //
+    .i_rd_inc          (w_fetch),                 //
+    .i_rd_aempty_thresh(i_wb4_out_aempty_thresh), //
+    .o_rd_almost_empty (o_wb4_out_almost_empty),  //
+    .o_rd_level        (o_wb4_out_level)          //
+  );
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read ACK
+  // Description : Registers the selected sub-word with its ack.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_out_sclk) begin : read_ack_proc
+    if (i_wb4_out_srst == 1'b1 || i_wb4_out_scyc == 1'b0) begin
+      r_read_ack  <= 1'b0;
+      r_read_data <= 0;
+    end
+    else begin
+      r_read_ack <= w_re;
+      if (w_re == 1'b1) begin
+        r_read_data <= r_head_data[r_unit_cnt*L_DATA_O_WIDTH +: L_DATA_O_WIDTH];
+      end
+    end
+  end // read_ack_proc
+  //
+  assign o_wb4_out_sack  = r_read_ack;
+  assign o_wb4_out_sdata = r_read_data;
+
+endmodule // wb4_dual_clock_fifo_1_to_N
@@ -16,7 +16,10 @@ Module Name  : wb4_dual_clock_fifo_N_to_1
 Description  : Wishbone B4(pipelined) dual clock FIFO Many-to-One data units 
 
 Additional Comments:
-   
+   P_SKID_BUFFER=1 puts a wb4_wr_skid_buffer in front of the write port and a
+   wb4_rd_skid_buffer behind the read port so STALL and DAT come from flops
+   on both sides instead of the full/empty logic. Bursts still run at one
+   beat per clock, the read buffer prefetches up to 4 words out of the FIFO.
 */
 module wb4_dual_clock_fifo_N_to_1 #(
   // FIFO Params
@@ -24,6 +27,7 @@ module wb4_dual_clock_fifo_N_to_1 #(
   parameter integer P_DATA_O_MSB = 31,           // FIFO Width-1
   parameter integer P_DEPTH      = 128,          // FIFO $clog2(Depth)-1
   parameter integer P_MASK_MSB   = P_DATA_O_MSB, // P_DATA_O_MSB=bit, (P_DATA_O_MSB+1)/4=nibble...
+  parameter integer P_SKID_BUFFER = 0,           // 1=Registered STALL/DAT on both ports
   // Write Synchronizers Params
   parameter integer P_WR_SYNC_DEPTH = 2, //
   // Read Synchronizers Params
@@ -37,6 +41,10 @@ module wb4_dual_clock_fifo_N_to_1 #(
   output                  o_wb4_in_sack,   // Write Strobe
   input  [P_DATA_I_MSB:0] i_wb4_in_sdata,  // Write Data
   output                  o_wb4_in_sstall, // Full?
+  // Write Side Fill Level (in output words)
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
   // Read Interface Signals 
   input                   i_wb4_out_sclk,   //
   input                   i_wb4_out_srst,   //
@@ -44,13 +52,19 @@ module wb4_dual_clock_fifo_N_to_1 #(
   input                   i_wb4_out_sstb,   // Read Strobe
   output                  o_wb4_out_sack,   // Write Strobe
   output [P_DATA_O_MSB:0] o_wb4_out_sdata,  // Read Data
-  output                  o_wb4_out_sstall  // Empty?
+  output                  o_wb4_out_sstall, // Empty?
+  // Read Side Fill Level (in output words)
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level          // Entries in use
 );
 
   ///////////////////////////////////////////////////////////////////////////////
   // Internal Parameter Declarations
   ///////////////////////////////////////////////////////////////////////////////
-  localparam L_ADDR_MSB = $clog2(P_DEPTH)-1;
+  localparam L_ADDR_MSB     = $clog2(P_DEPTH)-1;
+  localparam L_DATA_I_REPLI = (P_DATA_O_MSB+1)/(P_DATA_I_MSB+1);
+  localparam L_UNIT_CNT_MSB = (L_DATA_I_REPLI > 1) ? $clog2(L_DATA_I_REPLI)-1 : 0;
 
   ///////////////////////////////////////////////////////////////////////////////
   // Internal Signals Declarations
@@ -58,13 +72,24 @@ module wb4_dual_clock_fifo_N_to_1 #(
   // Write Proc
   reg r_write_ack;
   // Read Proc
-  reg r_read_ack;
+  reg                   r_read_ack;
+  wire [P_DATA_O_MSB:0] w_read_data;
+  // FIFO write port, straight from the bus or out of the skid buffer
+  wire                  w_wr_cyc;
+  wire                  w_wr_stb;
+  wire [P_DATA_I_MSB:0] w_wr_data;
+  // FIFO read port, straight from the bus or out of the skid buffer
+  wire       w_rd_cyc;
+  wire       w_rd_stb;
   // Write Controls Asynch Logic
   wire w_full;
-  wire w_we = i_wb4_in_scyc & i_wb4_in_sstb & ~w_full;
+  wire w_we = w_wr_cyc & w_wr_stb & ~w_full;
   // Read Controls Asynch Logic
   wire w_empty;
-  wire w_re = i_wb4_out_scyc & i_wb4_out_sstb & ~w_empty;
+  wire w_re = w_rd_cyc & w_rd_stb & ~w_empty;
+  // Fill Level, counts complete output words
+  reg [L_UNIT_CNT_MSB:0] r_unit_cnt;
+  wire                   w_word_we = w_we && (r_unit_cnt == L_DATA_I_REPLI-1);
 
   ///////////////////////////////////////////////////////////////////////////////
   //            ********      Architecture Declaration      ********           //
@@ -75,21 +100,13 @@ module wb4_dual_clock_fifo_N_to_1 #(
   // Description : .
   /////////////////////////////////////////////////////////////////////////////
   always @(posedge i_wb4_in_sclk) begin : write_ack_proc
-    if (i_wb4_in_srst == 1'b1 || i_wb4_in_scyc == 1'b0) begin
+    if (i_wb4_in_srst == 1'b1 || w_wr_cyc == 1'b0) begin
       r_write_ack <= 1'b0;
     end
     else begin
-      if(w_full == 1'b0) begin
-        // 
-        r_write_ack <= i_wb4_in_sstb;
-      end
-      else begin
-        r_write_ack <= 1'b0;
-      end
+      r_write_ack <= w_we;
     end
   end // write_ack_proc
-  //
-  assign o_wb4_in_sack = r_write_ack;
 
   ///////////////////////////////////////////////////////////////////////////////
   // Instance    : Dual Clock FIFO
@@ -110,37 +127,125 @@ module wb4_dual_clock_fifo_N_to_1 #(
     .i_wr_clk (i_wb4_in_sclk),   //
     .i_wr_rst (i_wb4_in_srst),   //
     .i_wr_inc (w_we),            //
-    .i_wr_data(i_wb4_in_sdata),  // 
+    .i_wr_data(w_wr_data),       // 
     .o_wr_full(w_full),          // 
     // Read
     .i_rd_clk  (i_wb4_out_sclk),   //
     .i_rd_rst  (i_wb4_out_srst),   //
     .i_rd_inc  (w_re),             //
-    .o_rd_data (o_wb4_out_sdata),  //
+    .o_rd_data (w_read_data),      //
     .o_rd_empty(w_empty)           //
   );
-  assign o_wb4_in_sstall  = w_full;
-  assign o_wb4_out_sstall = w_empty;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Output Word Counter
+  // Description : Tracks how many input words went into the current output word.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_in_sclk) begin : unit_cnt_proc
+    if (i_wb4_in_srst == 1'b1) begin
+      r_unit_cnt <= 'h0;
+    end
+    else if (w_we == 1'b1) begin
+      r_unit_cnt <= (r_unit_cnt == L_DATA_I_REPLI-1) ? 'h0 : r_unit_cnt + 1;
+    end
+  end // unit_cnt_proc
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Fill Level
+  // Description : Level and almost full/empty flags in each clock domain.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_dual_clock_fifo_level #(
+    .P_DEPTH        (P_DEPTH),         //
+    .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH), //
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)  //
+  ) fifo_level_inst (
+    // Write
+    .i_wr_clk         (i_wb4_in_sclk),         //
+    .i_wr_rst         (i_wb4_in_srst),         //
+    .i_wr_inc         (w_word_we),             //
+    .i_wr_afull_thresh(i_wb4_in_afull_thresh), //
+    .o_wr_almost_full (o_wb4_in_almost_full),  //
+    .o_wr_level       (o_wb4_in_level),        //
+    // Read
+    .i_rd_clk          (i_wb4_out_sclk),          //
+    .i_rd_rst          (i_wb4_out_srst),          //
+    .i_rd_inc          (w_re),                    //
+    .i_rd_aempty_thresh(i_wb4_out_aempty_thresh), //
+    .o_rd_almost_empty (o_wb4_out_almost_empty),  //
+    .o_rd_level        (o_wb4_out_level)          //
+  );
 
   /////////////////////////////////////////////////////////////////////////////
   // Process     :  Read Ack
   // Description : .
   /////////////////////////////////////////////////////////////////////////////
   always @(posedge i_wb4_out_sclk) begin : read_ack_proc
-    if (i_wb4_out_srst == 1'b1 || i_wb4_out_scyc == 1'b0) begin
+    if (i_wb4_out_srst == 1'b1 || w_rd_cyc == 1'b0) begin
       r_read_ack <= 1'b0;
     end
     else begin
-      if(w_empty == 1'b0) begin
-        // 
-        r_read_ack <= i_wb4_out_sstb;
-      end
-      else begin
-        r_read_ack <= 1'b0;
-      end
+      r_read_ack <= w_re;
     end
   end // read_ack_proc
-  // 
-  assign o_wb4_out_sack = r_read_ack;
+
+  generate
+    if (P_SKID_BUFFER == 1) begin: skid_buffer_gen
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Write Skid Buffer
+      // Description : Registered STALL and DAT on the write port.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_wr_skid_buffer #(
+        .P_DATA_MSB(P_DATA_I_MSB)
+      ) wr_skid_buffer_inst (
+        .i_clk   (i_wb4_in_sclk                                  ),
+        .i_rst   (i_wb4_in_srst                                  ),
+        .i_cyc   (i_wb4_in_scyc                                  ),
+        .i_stb   (i_wb4_in_sstb                                  ),
+        .i_data  (i_wb4_in_sdata                                 ),
+        .o_ack   (o_wb4_in_sack                                  ),
+        .o_stall (o_wb4_in_sstall                                ),
+        .o_cyc   (w_wr_cyc                                       ),
+        .o_stb   (w_wr_stb                                       ),
+        .o_data  (w_wr_data                                      ),
+        .i_accept(w_we                                           )
+      );
+
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Read Skid Buffer
+      // Description : Registered STALL and DAT on the read port. The buffer pops
+      //               one word at a time, no bursts on the FIFO side.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_rd_skid_buffer #(
+        .P_DATA_MSB(P_DATA_O_MSB)
+      ) rd_skid_buffer_inst (
+        .i_clk   (i_wb4_out_sclk  ),
+        .i_rst   (i_wb4_out_srst  ),
+        .i_cyc   (i_wb4_out_scyc  ),
+        .i_stb   (i_wb4_out_sstb  ),
+        .o_ack   (o_wb4_out_sack  ),
+        .o_data  (o_wb4_out_sdata ),
+        .o_stall (o_wb4_out_sstall),
+        .o_cyc   (w_rd_cyc        ),
+        .o_stb   (w_rd_stb        ),
+        .i_accept(w_re            ),
+        .i_ack   (r_read_ack      ),
+        .i_data  (w_read_data     )
+      );
+    end // skid_buffer_gen
+    else begin: no_skid_buffer_gen
+      // Write port
+      assign w_wr_cyc        = i_wb4_in_scyc;
+      assign w_wr_stb        = i_wb4_in_sstb;
+      assign w_wr_data       = i_wb4_in_sdata;
+      assign o_wb4_in_sack   = r_write_ack;
+      assign o_wb4_in_sstall = w_full;
+      // Read port
+      assign w_rd_cyc         = i_wb4_out_scyc;
+      assign w_rd_stb         = i_wb4_out_sstb;
+      assign o_wb4_out_sack   = r_read_ack;
+      assign o_wb4_out_sdata  = w_read_data;
+      assign o_wb4_out_sstall = w_empty;
+    end // no_skid_buffer_gen
+  endgenerate
 
 endmodule // wb4_dual_clock_fifo_N_to_1
@@ -0,0 +1,188 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_dual_clock_fifo_gearbox.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_dual_clock_fifo_gearbox
+Description  : Wishbone B4(pipelined) dual clock FIFO with any input and
+               output widths (gearbox), e.g. 24 to 32 or 10 to 8.
+
+Additional Comments:
+   A wb4_dual_clock_fifo_1_to_1 stores words of the wider width. The narrow
+   port goes through a gearbox in its own clock domain, wb4_gearbox_pack in
+   front of the write port when the input is narrower, wb4_gearbox_unpack
+   behind the read port when the output is. Both ports run one beat per
+   clock, the FIFO side moves a word only as often as the width ratio
+   needs. The level is in stored words and does not count the bits held in
+   the gearbox.
+*/
+module wb4_dual_clock_fifo_gearbox #(
+  parameter integer P_DATA_I_MSB = 23,  // FIFO Width-1
+  parameter integer P_DATA_O_MSB = 31,  // FIFO Width-1
+  parameter integer P_DEPTH      = 128, // FIFO Depth in stored (wider) words, power of 2 with the BRAM
+  parameter integer P_USE_BRAM   = 1,   // BRAM of LUT based
+  // Write Synchronizers Params
+  parameter integer P_WR_SYNC_DEPTH = 2, //
+  // Read Synchronizers Params
+  parameter integer P_RD_SYNC_DEPTH = 2  //
+)(
+  // Write Interface  Signals
+  input                   i_wb4_in_sclk,   //
+  input                   i_wb4_in_srst,   //
+  input                   i_wb4_in_scyc,   // Enable
+  input                   i_wb4_in_sstb,   // Write Strobe
+  output                  o_wb4_in_sack,   // Write Strobe
+  input  [P_DATA_I_MSB:0] i_wb4_in_sdata,  // Write Data
+  output                  o_wb4_in_sstall, // Full?
+  // Write Side Fill Level (in stored words)
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
+  // Read Interface Signals
+  input                   i_wb4_out_sclk,   //
+  input                   i_wb4_out_srst,   //
+  input                   i_wb4_out_scyc,   // Read Strobe
+  input                   i_wb4_out_sstb,   // Read Strobe
+  output                  o_wb4_out_sack,   // Write Strobe
+  output [P_DATA_O_MSB:0] o_wb4_out_sdata,  // Read Data
+  output                  o_wb4_out_sstall, // Empty?
+  // Read Side Fill Level (in stored words)
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level          // Entries in use
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_DATA_MSB = (P_DATA_I_MSB > P_DATA_O_MSB) ? P_DATA_I_MSB : P_DATA_O_MSB;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // FIFO write port, straight from the bus or out of the packer
+  wire                w_wr_cyc;
+  wire                w_wr_stb;
+  wire [L_DATA_MSB:0] w_wr_data;
+  wire                w_wr_ack;
+  wire                w_wr_stall;
+  // FIFO read port, straight to the bus or into the unpacker
+  wire                w_rd_cyc;
+  wire                w_rd_stb;
+  wire [L_DATA_MSB:0] w_rd_data;
+  wire                w_rd_ack;
+  wire                w_rd_stall;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  generate
+    if (P_DATA_I_MSB < P_DATA_O_MSB) begin: pack_gen
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Write Gearbox
+      // Description : Packs the narrow input words into stored words.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_gearbox_pack #(
+        .P_DATA_I_MSB(P_DATA_I_MSB),
+        .P_DATA_O_MSB(P_DATA_O_MSB)
+      ) wr_gearbox_inst (
+        .i_clk  (i_wb4_in_sclk  ),
+        .i_rst  (i_wb4_in_srst  ),
+        .i_cyc  (i_wb4_in_scyc  ),
+        .i_stb  (i_wb4_in_sstb  ),
+        .i_data (i_wb4_in_sdata ),
+        .o_ack  (o_wb4_in_sack  ),
+        .o_stall(o_wb4_in_sstall),
+        .o_cyc  (w_wr_cyc       ),
+        .o_stb  (w_wr_stb       ),
+        .o_data (w_wr_data      ),
+        .i_stall(w_wr_stall     )
+      );
+      // Read port
+      assign w_rd_cyc         = i_wb4_out_scyc;
+      assign w_rd_stb         = i_wb4_out_sstb;
+      assign o_wb4_out_sack   = w_rd_ack;
+      assign o_wb4_out_sdata  = w_rd_data;
+      assign o_wb4_out_sstall = w_rd_stall;
+    end // pack_gen
+    else begin: unpack_gen
+      // Write port
+      assign w_wr_cyc        = i_wb4_in_scyc;
+      assign w_wr_stb        = i_wb4_in_sstb;
+      assign w_wr_data       = i_wb4_in_sdata;
+      assign o_wb4_in_sack   = w_wr_ack;
+      assign o_wb4_in_sstall = w_wr_stall;
+
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Read Gearbox
+      // Description : Splits the stored words into the narrow output words.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_gearbox_unpack #(
+        .P_DATA_I_MSB(P_DATA_I_MSB),
+        .P_DATA_O_MSB(P_DATA_O_MSB)
+      ) rd_gearbox_inst (
+        .i_clk  (i_wb4_out_sclk  ),
+        .i_rst  (i_wb4_out_srst  ),
+        .i_cyc  (i_wb4_out_scyc  ),
+        .i_stb  (i_wb4_out_sstb  ),
+        .o_ack  (o_wb4_out_sack  ),
+        .o_data (o_wb4_out_sdata ),
+        .o_stall(o_wb4_out_sstall),
+        .o_cyc  (w_rd_cyc        ),
+        .o_stb  (w_rd_stb        ),
+        .i_stall(w_rd_stall      ),
+        .i_ack  (w_rd_ack        ),
+        .i_data (w_rd_data       )
+      );
+    end // unpack_gen
+  endgenerate
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Dual Clock 1 to 1 FIFO
+  // Description : Stores the wider words.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_dual_clock_fifo_1_to_1 #(
+    .P_DATA_MSB(L_DATA_MSB), // FIFO Width-1
+    .P_DEPTH   (P_DEPTH   ), // FIFO Depth
+    .P_USE_BRAM(P_USE_BRAM), // BRAM of LUT based
+    // CDC Params
+    .P_WR_SYNC_DEPTH(P_WR_SYNC_DEPTH),
+    .P_RD_SYNC_DEPTH(P_RD_SYNC_DEPTH)
+  ) wb4_dual_clock_fifo_1_to_1_inst (
+    // Write Interface  Signals
+    .i_wb4_in_sclk  (i_wb4_in_sclk), //
+    .i_wb4_in_srst  (i_wb4_in_srst), //
+    .i_wb4_in_scyc  (w_wr_cyc  ), // Enable
+    .i_wb4_in_sstb  (w_wr_stb  ), // Write Strobe
+    .o_wb4_in_sack  (w_wr_ack  ), // Write Acknowledge
+    .i_wb4_in_sdata (w_wr_data ), // Write Data
+    .o_wb4_in_sstall(w_wr_stall), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(i_wb4_in_afull_thresh), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full ), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level       ), // Entries in use
+    // Read Interface Signals
+    .i_wb4_out_sclk  (i_wb4_out_sclk), //
+    .i_wb4_out_srst  (i_wb4_out_srst), //
+    .i_wb4_out_scyc  (w_rd_cyc  ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_rd_stb  ), // Read Strobe
+    .o_wb4_out_sack  (w_rd_ack  ), // Read Acknowledge
+    .o_wb4_out_sdata (w_rd_data ), // Read Data
+    .o_wb4_out_sstall(w_rd_stall), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(i_wb4_out_aempty_thresh), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty ), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level        )  // Entries in use
+  );
+
+endmodule // wb4_dual_clock_fifo_gearbox
@@ -0,0 +1,166 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_dual_clock_fifo_level.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_dual_clock_fifo_level
+Description  : Fill level and almost full/empty flags for the dual clock FIFO,
+               one set per clock domain.
+
+Additional Comments:
+   Mirrors the dual_clock_fifo pointer scheme. Each domain keeps a binary and
+   a gray coded count of its increments; the gray count is synchronized into
+   the other domain, converted back to binary and subtracted. The level seen
+   by each domain is therefore pessimistic by the synchronizer latency, which
+   keeps almost full and almost empty safe to act on.
+   P_CLK_MODE=1 follows the related clock handoff of the 1 to 1 LUT FIFO,
+   the other domain's gray count is taken off its register without the
+   synchronizers.
+*/
+module wb4_dual_clock_fifo_level #(
+  parameter integer P_DEPTH         = 128, // FIFO Depth in storage entries
+  parameter integer P_CLK_MODE      = 0,   // 0=Asynchronous clocks, 1=Related clocks
+  // Write Synchronizers Params
+  parameter integer P_WR_SYNC_DEPTH = 2,   //
+  // Read Synchronizers Params
+  parameter integer P_RD_SYNC_DEPTH = 2    //
+)(
+  // Write Domain
+  input                      i_wr_clk,         //
+  input                      i_wr_rst,         //
+  input                      i_wr_inc,         // One entry written
+  input  [$clog2(P_DEPTH):0] i_wr_afull_thresh, // Almost Full when level >= thresh
+  output                     o_wr_almost_full, //
+  output [$clog2(P_DEPTH):0] o_wr_level,       // Entries in use
+  // Read Domain
+  input                      i_rd_clk,          //
+  input                      i_rd_rst,          //
+  input                      i_rd_inc,          // One entry read
+  input  [$clog2(P_DEPTH):0] i_rd_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_rd_almost_empty, //
+  output [$clog2(P_DEPTH):0] o_rd_level         // Entries in use
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_PTR_MSB = $clog2(P_DEPTH);
+  localparam integer L_PTR_PAD = L_PTR_MSB;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Write Domain
+  reg [L_PTR_MSB:0] r_wr_bin;
+  reg [L_PTR_MSB:0] r_wr_gray;
+  reg [L_PTR_MSB:0] r_rd_gray_sync [0:P_WR_SYNC_DEPTH-1];
+  reg [L_PTR_MSB:0] r_wr_level;
+  reg               r_wr_almost_full;
+  // Read Domain
+  reg [L_PTR_MSB:0] r_rd_bin;
+  reg [L_PTR_MSB:0] r_rd_gray;
+  reg [L_PTR_MSB:0] r_wr_gray_sync [0:P_RD_SYNC_DEPTH-1];
+  reg [L_PTR_MSB:0] r_rd_level;
+  reg               r_rd_almost_empty;
+  //
+  integer wr_stage;
+  integer rd_stage;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Function    : Gray to Binary
+  // Description :
+  ///////////////////////////////////////////////////////////////////////////////
+  function [L_PTR_MSB:0] gray2bin;
+    input [L_PTR_MSB:0] gray;
+    integer bit_idx;
+    begin
+      gray2bin[L_PTR_MSB] = gray[L_PTR_MSB];
+      for (bit_idx = L_PTR_MSB-1; bit_idx >= 0; bit_idx = bit_idx-1) begin
+        gray2bin[bit_idx] = gray2bin[bit_idx+1] ^ gray[bit_idx];
+      end
+    end
+  endfunction
+
+  // Write Domain Asynch Logic
+  wire [L_PTR_MSB:0] w_wr_bin_next  = r_wr_bin + {{L_PTR_PAD{1'b0}}, {i_wr_inc}};
+  wire [L_PTR_MSB:0] w_rd_bin_sync  = gray2bin((P_CLK_MODE == 1) ? r_rd_gray : r_rd_gray_sync[P_WR_SYNC_DEPTH-1]);
+  wire [L_PTR_MSB:0] w_wr_level     = w_wr_bin_next - w_rd_bin_sync;
+  // Read Domain Asynch Logic
+  wire [L_PTR_MSB:0] w_rd_bin_next  = r_rd_bin + {{L_PTR_PAD{1'b0}}, {i_rd_inc}};
+  wire [L_PTR_MSB:0] w_wr_bin_sync  = gray2bin((P_CLK_MODE == 1) ? r_wr_gray : r_wr_gray_sync[P_RD_SYNC_DEPTH-1]);
+  wire [L_PTR_MSB:0] w_rd_level     = w_wr_bin_sync - w_rd_bin_next;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Domain Level Process
+  // Description :
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wr_clk) begin : wr_level_proc
+    if (i_wr_rst == 1'b1) begin
+      r_wr_bin         <= 'h0;
+      r_wr_gray        <= 'h0;
+      r_wr_level       <= 'h0;
+      r_wr_almost_full <= 1'b0;
+      for (wr_stage = 0; wr_stage < P_WR_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+        r_rd_gray_sync[wr_stage] <= 'h0;
+      end
+    end
+    else begin
+      r_wr_bin         <= w_wr_bin_next;
+      r_wr_gray        <= w_wr_bin_next ^ (w_wr_bin_next >> 1);
+      r_wr_level       <= w_wr_level;
+      r_wr_almost_full <= (w_wr_level >= i_wr_afull_thresh) ? 1'b1 : 1'b0;
+      // Read pointer synchronizer
+      r_rd_gray_sync[0] <= r_rd_gray;
+      for (wr_stage = 1; wr_stage < P_WR_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+        r_rd_gray_sync[wr_stage] <= r_rd_gray_sync[wr_stage-1];
+      end
+    end
+  end // wr_level_proc
+  //
+  assign o_wr_level       = r_wr_level;
+  assign o_wr_almost_full = r_wr_almost_full;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read Domain Level Process
+  // Description :
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_rd_clk) begin : rd_level_proc
+    if (i_rd_rst == 1'b1) begin
+      r_rd_bin          <= 'h0;
+      r_rd_gray         <= 'h0;
+      r_rd_level        <= 'h0;
+      r_rd_almost_empty <= 1'b1;
+      for (rd_stage = 0; rd_stage < P_RD_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+        r_wr_gray_sync[rd_stage] <= 'h0;
+      end
+    end
+    else begin
+      r_rd_bin          <= w_rd_bin_next;
+      r_rd_gray         <= w_rd_bin_next ^ (w_rd_bin_next >> 1);
+      r_rd_level        <= w_rd_level;
+      r_rd_almost_empty <= (w_rd_level <= i_rd_aempty_thresh) ? 1'b1 : 1'b0;
+      // Write pointer synchronizer
+      r_wr_gray_sync[0] <= r_wr_gray;
+      for (rd_stage = 1; rd_stage < P_RD_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+        r_wr_gray_sync[rd_stage] <= r_wr_gray_sync[rd_stage-1];
+      end
+    end
+  end // rd_level_proc
+  //
+  assign o_rd_level        = r_rd_level;
+  assign o_rd_almost_empty = r_rd_almost_empty;
+
+endmodule // wb4_dual_clock_fifo_level
@@ -0,0 +1,319 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_dual_clock_fifo_packet.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_dual_clock_fifo_packet
+Description  : Wishbone B4(pipelined) dual clock FIFO One-to-One data units,
+               packet aware.
+
+Additional Comments:
+   Every stored word carries an end-of-packet (EOP) and an error bit next to
+   the data. The write domain keeps a write pointer and a commit pointer, an
+   accepted beat with i_wb4_in_seop commits the frame.
+   Store-and-forward (P_CUT_THROUGH=0): only committed frames are published to
+   the read domain. i_wb4_in_sabort (sampled while CYC is high, with or
+   without a beat) rolls the write pointer back to the commit pointer, so a
+   partial frame is dropped in one clock. Frames must fit in P_DEPTH.
+   Cut-through (P_CUT_THROUGH=1): every word is published as it is written.
+   i_wb4_in_sabort qualifies a beat, that beat is stored as the EOP of the
+   frame with the error bit set, it is read out with o_wb4_out_sabort so the
+   consumer can drop the frame. The beat itself completes with ACK.
+   The commit pointer can jump by a whole frame, it is published to the read
+   domain one increment per write clock so the gray coded copy that crosses
+   the clock domains never changes more than one bit at a time.
+   The pointers that cross keep the natural binary wrap of their extra bit,
+   so any P_DEPTH works: the memory index is a separate modulo P_DEPTH count
+   kept next to each pointer in its own domain.
+*/
+module wb4_dual_clock_fifo_packet #(
+  parameter integer P_DATA_MSB    = 7,   // FIFO Width-1
+  parameter integer P_DEPTH       = 128, // FIFO Depth, any value
+  parameter integer P_CUT_THROUGH = 0,   // 0=Store-and-forward, 1=Cut-through
+  parameter integer P_BANK_DEPTH  = 0,   // 0=One memory, else BRAM bank depth (power of 2)
+  // Write Synchronizers Params
+  parameter integer P_WR_SYNC_DEPTH = 2, //
+  // Read Synchronizers Params
+  parameter integer P_RD_SYNC_DEPTH = 2  //
+)(
+  // Write Interface  Signals
+  input                 i_wb4_in_sclk,   //
+  input                 i_wb4_in_srst,   //
+  input                 i_wb4_in_scyc,   // Enable
+  input                 i_wb4_in_sstb,   // Write Strobe
+  output                o_wb4_in_sack,   // Write Strobe
+  input  [P_DATA_MSB:0] i_wb4_in_sdata,  // Write Data
+  output                o_wb4_in_sstall, // Full?
+  input                 i_wb4_in_seop,   // Last word of the frame
+  input                 i_wb4_in_sabort, // Drop/flag the frame being written
+  // Write Side Fill Level, committed and uncommitted words
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
+  // Read Interface Signals
+  input                 i_wb4_out_sclk,   //
+  input                 i_wb4_out_srst,   //
+  input                 i_wb4_out_scyc,   // Read Cycle, Abort
+  input                 i_wb4_out_sstb,   // Read Strobe
+  output                o_wb4_out_sack,   // Write Strobe
+  output [P_DATA_MSB:0] o_wb4_out_sdata,  // Read Data
+  output                o_wb4_out_sstall, // Empty?
+  output                o_wb4_out_seop,   // Last word of the frame, valid with ACK
+  output                o_wb4_out_sabort, // Frame was aborted, valid with ACK
+  // Read Side Fill Level, published words only
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level          // Entries in use
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_ADDR_MSB = $clog2(P_DEPTH)-1;
+  localparam integer L_BANK_ADDR_MSB = (P_BANK_DEPTH == 0) ? L_ADDR_MSB : $clog2(P_BANK_DEPTH)-1;
+  // The pointers carry one extra wrap bit so all P_DEPTH entries are usable.
+  localparam integer L_PTR_MSB  = L_ADDR_MSB+1;
+  localparam integer L_PTR_PAD  = L_PTR_MSB;
+  localparam integer L_POW2     = ((P_DEPTH & (P_DEPTH-1)) == 0) ? 1 : 0;
+  // Stored word, {err, eop, data}
+  localparam integer L_WORD_MSB = P_DATA_MSB+2;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Write Domain
+  reg [L_PTR_MSB:0] r_wr_ptr;
+  reg [L_PTR_MSB:0] r_commit_ptr;
+  reg [L_ADDR_MSB:0] r_wr_addr;     // Memory index of r_wr_ptr
+  reg [L_ADDR_MSB:0] r_commit_addr; // Memory index of r_commit_ptr
+  reg [L_PTR_MSB:0] r_pub_ptr;   // Commit pointer as seen by the read domain
+  reg [L_PTR_MSB:0] r_pub_gray;
+  reg [L_PTR_MSB:0] r_rd_gray_sync [0:P_WR_SYNC_DEPTH-1];
+  reg [L_PTR_MSB:0] r_wr_level;
+  reg               r_wr_almost_full;
+  reg               r_write_ack;
+  // Read Domain
+  reg [L_PTR_MSB:0] r_rd_ptr;
+  reg [L_ADDR_MSB:0] r_rd_addr;    // Memory index of r_rd_ptr
+  reg [L_PTR_MSB:0] r_rd_gray;
+  reg [L_PTR_MSB:0] r_pub_gray_sync [0:P_RD_SYNC_DEPTH-1];
+  reg [L_PTR_MSB:0] r_rd_level;
+  reg               r_rd_almost_empty;
+  reg               r_read_ack;
+  //
+  wire [L_WORD_MSB:0] w_read_word;
+  //
+  integer wr_stage;
+  integer rd_stage;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Function    : Gray to Binary
+  // Description :
+  ///////////////////////////////////////////////////////////////////////////////
+  function [L_PTR_MSB:0] gray2bin;
+    input [L_PTR_MSB:0] gray;
+    integer bit_idx;
+    begin
+      gray2bin[L_PTR_MSB] = gray[L_PTR_MSB];
+      for (bit_idx = L_PTR_MSB-1; bit_idx >= 0; bit_idx = bit_idx-1) begin
+        gray2bin[bit_idx] = gray2bin[bit_idx+1] ^ gray[bit_idx];
+      end
+    end
+  endfunction
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Function    : Modulo Address Increment
+  // Description : Wraps at P_DEPTH, the natural binary wrap with a power of 2
+  //               depth.
+  ///////////////////////////////////////////////////////////////////////////////
+  function [L_ADDR_MSB:0] addr_inc;
+    input [L_ADDR_MSB:0] addr;
+    input                inc;
+    begin
+      if (L_POW2 == 1 || addr != P_DEPTH-1) begin
+        addr_inc = addr + {{L_ADDR_MSB{1'b0}}, {inc}};
+      end
+      else begin
+        addr_inc = (inc == 1'b1) ? {(L_ADDR_MSB+1){1'b0}} : addr;
+      end
+    end
+  endfunction
+
+  // Write Domain Asynch Logic
+  wire [L_PTR_MSB:0] w_rd_ptr_sync = gray2bin(r_rd_gray_sync[P_WR_SYNC_DEPTH-1]);
+  wire [L_PTR_MSB:0] w_wr_used     = r_wr_ptr - w_rd_ptr_sync;
+  wire               w_full        = (w_wr_used == P_DEPTH) ? 1'b1 : 1'b0;
+  wire               w_we          = i_wb4_in_scyc & i_wb4_in_sstb & ~w_full;
+  wire               w_abort       = i_wb4_in_scyc & i_wb4_in_sabort;
+  // Store-and-forward drops the frame, the aborted beat is not stored either.
+  wire               w_rollback    = (P_CUT_THROUGH == 0) ? w_abort : 1'b0;
+  wire               w_store       = w_we & ~w_rollback;
+  wire               w_commit      = (P_CUT_THROUGH == 1) ? w_store :
+                                     (w_store & i_wb4_in_seop);
+  wire [L_PTR_MSB:0] w_wr_ptr_inc  = r_wr_ptr + {{L_PTR_PAD{1'b0}}, {1'b1}};
+  wire [L_PTR_MSB:0] w_wr_ptr_next = (w_rollback == 1'b1) ? r_commit_ptr :
+                                     (w_store == 1'b1)    ? w_wr_ptr_inc : r_wr_ptr;
+  wire [L_ADDR_MSB:0] w_wr_addr_inc  = addr_inc(r_wr_addr, 1'b1);
+  wire [L_ADDR_MSB:0] w_wr_addr_next = (w_rollback == 1'b1) ? r_commit_addr :
+                                       (w_store == 1'b1)    ? w_wr_addr_inc : r_wr_addr;
+  wire [L_PTR_MSB:0] w_pub_ptr_next = (r_pub_ptr != r_commit_ptr) ? r_pub_ptr + {{L_PTR_PAD{1'b0}}, {1'b1}} : r_pub_ptr;
+  wire [L_PTR_MSB:0] w_wr_level     = w_wr_ptr_next - w_rd_ptr_sync;
+  // Cut-through flags an aborted beat as a bad end of frame.
+  wire [L_WORD_MSB:0] w_write_word  = {(w_abort & (P_CUT_THROUGH == 1)),
+                                       (i_wb4_in_seop | w_abort),
+                                       i_wb4_in_sdata};
+  // Read Domain Asynch Logic
+  wire [L_PTR_MSB:0] w_pub_ptr_sync = gray2bin(r_pub_gray_sync[P_RD_SYNC_DEPTH-1]);
+  wire               w_empty        = (r_rd_ptr == w_pub_ptr_sync) ? 1'b1 : 1'b0;
+  wire               w_re           = i_wb4_out_scyc & i_wb4_out_sstb & ~w_empty;
+  wire [L_PTR_MSB:0] w_rd_ptr_next  = r_rd_ptr + {{L_PTR_PAD{1'b0}}, {w_re}};
+  wire [L_PTR_MSB:0] w_rd_level     = w_pub_ptr_sync - w_rd_ptr_next;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Domain Process
+  // Description : Write, commit and publish pointers, read pointer
+  //               synchronizer and write side level.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_in_sclk) begin : write_proc
+    if (i_wb4_in_srst == 1'b1) begin
+      r_wr_ptr         <= 'h0;
+      r_commit_ptr     <= 'h0;
+      r_wr_addr        <= 'h0;
+      r_commit_addr    <= 'h0;
+      r_pub_ptr        <= 'h0;
+      r_pub_gray       <= 'h0;
+      r_wr_level       <= 'h0;
+      r_wr_almost_full <= 1'b0;
+      for (wr_stage = 0; wr_stage < P_WR_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+        r_rd_gray_sync[wr_stage] <= 'h0;
+      end
+    end
+    else begin
+      r_wr_ptr   <= w_wr_ptr_next;
+      r_wr_addr  <= w_wr_addr_next;
+      r_pub_ptr  <= w_pub_ptr_next;
+      r_pub_gray <= w_pub_ptr_next ^ (w_pub_ptr_next >> 1);
+      if (w_commit == 1'b1) begin
+        r_commit_ptr  <= w_wr_ptr_inc;
+        r_commit_addr <= w_wr_addr_inc;
+      end
+      r_wr_level       <= w_wr_level;
+      r_wr_almost_full <= (w_wr_level >= i_wb4_in_afull_thresh) ? 1'b1 : 1'b0;
+      // Read pointer synchronizer
+      r_rd_gray_sync[0] <= r_rd_gray;
+      for (wr_stage = 1; wr_stage < P_WR_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+        r_rd_gray_sync[wr_stage] <= r_rd_gray_sync[wr_stage-1];
+      end
+    end
+  end // write_proc
+  //
+  assign o_wb4_in_level       = r_wr_level;
+  assign o_wb4_in_almost_full = r_wr_almost_full;
+  assign o_wb4_in_sstall      = w_full;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write ACK Process
+  // Description : An aborted beat is acked, it was taken off the bus.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_in_sclk) begin : write_ack_proc
+    if (i_wb4_in_srst == 1'b1 || i_wb4_in_scyc == 1'b0) begin
+      r_write_ack <= 1'b0;
+    end
+    else begin
+      r_write_ack <= w_we;
+    end
+  end // write_ack_proc
+  //
+  assign o_wb4_in_sack = r_write_ack;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read Domain Process
+  // Description : Read pointer, published pointer synchronizer and read side
+  //               level.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_out_sclk) begin : read_proc
+    if (i_wb4_out_srst == 1'b1) begin
+      r_rd_ptr          <= 'h0;
+      r_rd_addr         <= 'h0;
+      r_rd_gray         <= 'h0;
+      r_rd_level        <= 'h0;
+      r_rd_almost_empty <= 1'b1;
+      for (rd_stage = 0; rd_stage < P_RD_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+        r_pub_gray_sync[rd_stage] <= 'h0;
+      end
+    end
+    else begin
+      r_rd_ptr          <= w_rd_ptr_next;
+      r_rd_addr         <= addr_inc(r_rd_addr, w_re);
+      r_rd_gray         <= w_rd_ptr_next ^ (w_rd_ptr_next >> 1);
+      r_rd_level        <= w_rd_level;
+      r_rd_almost_empty <= (w_rd_level <= i_wb4_out_aempty_thresh) ? 1'b1 : 1'b0;
+      // Published pointer synchronizer
+      r_pub_gray_sync[0] <= r_pub_gray;
+      for (rd_stage = 1; rd_stage < P_RD_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+        r_pub_gray_sync[rd_stage] <= r_pub_gray_sync[rd_stage-1];
+      end
+    end
+  end // read_proc
+  //
+  assign o_wb4_out_level        = r_rd_level;
+  assign o_wb4_out_almost_empty = r_rd_almost_empty;
+  assign o_wb4_out_sstall       = w_empty;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read ACK
+  // Description : The BRAM output register holds the popped word.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wb4_out_sclk) begin : read_ack_proc
+    if (i_wb4_out_srst == 1'b1 || i_wb4_out_scyc == 1'b0) begin
+      r_read_ack <= 1'b0;
+    end
+    else begin
+      r_read_ack <= w_re;
+    end
+  end // read_ack_proc
+  //
+  assign o_wb4_out_sack  = r_read_ack;
+  assign o_wb4_out_sdata = w_read_word[P_DATA_MSB:0];
+  assign o_wb4_out_seop  = w_read_word[P_DATA_MSB+1];
+  assign o_wb4_out_sabort = w_read_word[P_DATA_MSB+2];
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Dual Clock BRAM
+  // Description : Inferrable Block RAM, one clock per port, banked by P_BANK_DEPTH.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_banked_sbram #(
+    // Compile time configurable parameters
+    .P_SBRAM_DATA_MSB (L_WORD_MSB),
+    .P_SBRAM_ADDR_MSB (L_ADDR_MSB),
+    .P_SBRAM_MASK_MSB (0),
+    .P_SBRAM_DEPTH    (P_DEPTH),
+    .P_BANK_ADDR_MSB  (L_BANK_ADDR_MSB),
+    .P_SBRAM_HAS_FILE (0),
+    .P_SBRAM_INIT_FILE(0)
+  ) fifo_mem_inst (
+    .i_ce   (1'b1                    ),
+    .i_wclk (i_wb4_in_sclk           ),
+    .i_rclk (i_wb4_out_sclk          ),
+    .i_waddr(r_wr_addr               ),
+    .i_raddr(r_rd_addr               ),
+    .i_we   (w_store                 ),
+    .i_mask (0                       ), // 0=writes, 1=masks
+    .i_wdata(w_write_word            ),
+    .o_rdata(w_read_word             )
+  );
+
+endmodule // wb4_dual_clock_fifo_packet
@@ -0,0 +1,275 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_fifo_stats.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_fifo_stats
+Description  : FIFO statistics counters with a Wishbone B4(pipelined) CSR
+               slave port.
+
+Additional Comments:
+   Counts on each side of a FIFO, in that side's clock domain. The CSR port
+   runs on the write clock. All counters saturate at all ones.
+   Register map (32 bit words, i_csr_adr):
+     0 CTRL       write: bit 0 snapshot, bit 1 clear (both = read and clear)
+                  read : bit 0 busy, a command is still crossing
+     1 WRITES     writes accepted
+     2 READS      reads accepted
+     3 WR_STALLS  clocks a write strobe was stalled
+     4 RD_STALLS  clocks a read strobe was stalled
+     5 HIGH_WATER highest write side level
+     6 OVERFLOWS  writes that found the FIFO full (stall start or RTY/ERR)
+     7 UNDERFLOWS reads that found the FIFO empty (stall start or RTY/ERR)
+   The counter registers read the last snapshot, every counter is copied at
+   once so they read as one consistent set. A command is a toggle crossed
+   into the read domain and back, CTRL writes while busy are dropped and the
+   read side snapshot is only valid once busy is low.
+*/
+module wb4_fifo_stats #(
+  parameter integer P_LEVEL_MSB  = 7, // Level Width-1, at most 30
+  parameter integer P_SYNC_DEPTH = 2  // Command/acknowledge synchronizer stages
+)(
+  // Write Domain, the CSR port runs on this clock
+  input                 i_wr_clk,     // clock
+  input                 i_wr_rst,     // reset
+  input                 i_wr_accept,  // Write taken by the FIFO
+  input                 i_wr_stall,   // Write strobe stalled
+  input                 i_wr_refused, // Write terminated with RTY/ERR
+  input [P_LEVEL_MSB:0] i_wr_level,   // Write side level
+  // Read Domain
+  input                 i_rd_clk,     // clock
+  input                 i_rd_rst,     // reset
+  input                 i_rd_accept,  // Read taken by the FIFO
+  input                 i_rd_stall,   // Read strobe stalled
+  input                 i_rd_refused, // Read terminated with RTY/ERR
+  // CSR Slave Interface
+  input         i_csr_cyc,   // Cycle
+  input         i_csr_stb,   // Strobe
+  input         i_csr_we,    // Write Enable
+  input  [2:0]  i_csr_adr,   // Register
+  input  [31:0] i_csr_data,  // Write Data
+  output        o_csr_ack,   // Acknowledge
+  output [31:0] o_csr_data,  // Read Data
+  output        o_csr_stall  // Never stalls
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam [2:0] L_CTRL       = 3'd0;
+  localparam [2:0] L_WRITES     = 3'd1;
+  localparam [2:0] L_READS      = 3'd2;
+  localparam [2:0] L_WR_STALLS  = 3'd3;
+  localparam [2:0] L_RD_STALLS  = 3'd4;
+  localparam [2:0] L_HIGH_WATER = 3'd5;
+  localparam [2:0] L_OVERFLOWS  = 3'd6;
+  localparam [2:0] L_UNDERFLOWS = 3'd7;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Write Domain
+  reg [31:0]          r_writes;
+  reg [31:0]          r_wr_stalls;
+  reg [31:0]          r_overflows;
+  reg [P_LEVEL_MSB:0] r_high_water;
+  reg                 r_wr_stall_d;
+  reg [31:0]          r_writes_snap;
+  reg [31:0]          r_wr_stalls_snap;
+  reg [31:0]          r_overflows_snap;
+  reg [P_LEVEL_MSB:0] r_high_water_snap;
+  reg [1:0]           r_cmd;
+  reg                 r_cmd_tgl;
+  reg                 r_ack_sync [0:P_SYNC_DEPTH-1];
+  reg                 r_csr_ack;
+  reg [31:0]          r_csr_data;
+  // Read Domain
+  reg [31:0] r_reads;
+  reg [31:0] r_rd_stalls;
+  reg [31:0] r_underflows;
+  reg        r_rd_stall_d;
+  reg [31:0] r_reads_snap;
+  reg [31:0] r_rd_stalls_snap;
+  reg [31:0] r_underflows_snap;
+  reg        r_cmd_sync [0:P_SYNC_DEPTH-1];
+  reg        r_rd_tgl;
+  //
+  integer wr_stage;
+  integer rd_stage;
+  //
+  wire w_busy      = r_cmd_tgl ^ r_ack_sync[P_SYNC_DEPTH-1];
+  wire w_csr_cmd   = i_csr_cyc & i_csr_stb & i_csr_we & ~w_busy & (i_csr_adr == L_CTRL);
+  wire w_wr_snap   = w_csr_cmd & i_csr_data[0];
+  wire w_wr_clear  = w_csr_cmd & i_csr_data[1];
+  wire w_overflow  = i_wr_refused | (i_wr_stall & ~r_wr_stall_d);
+  wire w_rd_cmd    = r_cmd_sync[P_SYNC_DEPTH-1] ^ r_rd_tgl;
+  wire w_rd_snap   = w_rd_cmd & r_cmd[0];
+  wire w_rd_clear  = w_rd_cmd & r_cmd[1];
+  wire w_underflow = i_rd_refused | (i_rd_stall & ~r_rd_stall_d);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Function    : Saturating Increment
+  // Description :
+  ///////////////////////////////////////////////////////////////////////////////
+  function [31:0] sat_inc;
+    input [31:0] count;
+    input        inc;
+    begin
+      sat_inc = (inc == 1'b1 && count != {32{1'b1}}) ? count+1 : count;
+    end
+  endfunction
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Domain Counters Process
+  // Description : A snapshot copies the counts before a clear in the same
+  //               command zeroes them.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wr_clk) begin : wr_count_proc
+    if (i_wr_rst == 1'b1) begin
+      r_writes          <= 32'h0;
+      r_wr_stalls       <= 32'h0;
+      r_overflows       <= 32'h0;
+      r_high_water      <= 'h0;
+      r_wr_stall_d      <= 1'b0;
+      r_writes_snap     <= 32'h0;
+      r_wr_stalls_snap  <= 32'h0;
+      r_overflows_snap  <= 32'h0;
+      r_high_water_snap <= 'h0;
+    end
+    else begin
+      r_wr_stall_d <= i_wr_stall;
+      if (w_wr_snap == 1'b1) begin
+        r_writes_snap     <= r_writes;
+        r_wr_stalls_snap  <= r_wr_stalls;
+        r_overflows_snap  <= r_overflows;
+        r_high_water_snap <= r_high_water;
+      end
+      if (w_wr_clear == 1'b1) begin
+        r_writes     <= 32'h0;
+        r_wr_stalls  <= 32'h0;
+        r_overflows  <= 32'h0;
+        r_high_water <= 'h0;
+      end
+      else begin
+        r_writes    <= sat_inc(r_writes, i_wr_accept);
+        r_wr_stalls <= sat_inc(r_wr_stalls, i_wr_stall);
+        r_overflows <= sat_inc(r_overflows, w_overflow);
+        if (i_wr_level > r_high_water) begin
+          r_high_water <= i_wr_level;
+        end
+      end
+    end
+  end // wr_count_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Command Process
+  // Description : The command is held with its toggle until the read domain
+  //               toggles back.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wr_clk) begin : cmd_proc
+    if (i_wr_rst == 1'b1) begin
+      r_cmd     <= 2'b00;
+      r_cmd_tgl <= 1'b0;
+      for (wr_stage = 0; wr_stage < P_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+        r_ack_sync[wr_stage] <= 1'b0;
+      end
+    end
+    else begin
+      if (w_csr_cmd == 1'b1) begin
+        r_cmd     <= i_csr_data[1:0];
+        r_cmd_tgl <= ~r_cmd_tgl;
+      end
+      // Read domain toggle synchronizer
+      r_ack_sync[0] <= r_rd_tgl;
+      for (wr_stage = 1; wr_stage < P_SYNC_DEPTH; wr_stage = wr_stage+1) begin
+        r_ack_sync[wr_stage] <= r_ack_sync[wr_stage-1];
+      end
+    end
+  end // cmd_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read Domain Counters Process
+  // Description : Same as the write domain, on the synchronized command.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_rd_clk) begin : rd_count_proc
+    if (i_rd_rst == 1'b1) begin
+      r_reads           <= 32'h0;
+      r_rd_stalls       <= 32'h0;
+      r_underflows      <= 32'h0;
+      r_rd_stall_d      <= 1'b0;
+      r_reads_snap      <= 32'h0;
+      r_rd_stalls_snap  <= 32'h0;
+      r_underflows_snap <= 32'h0;
+      r_rd_tgl          <= 1'b0;
+      for (rd_stage = 0; rd_stage < P_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+        r_cmd_sync[rd_stage] <= 1'b0;
+      end
+    end
+    else begin
+      r_rd_stall_d <= i_rd_stall;
+      r_rd_tgl     <= r_cmd_sync[P_SYNC_DEPTH-1];
+      // Write domain toggle synchronizer
+      r_cmd_sync[0] <= r_cmd_tgl;
+      for (rd_stage = 1; rd_stage < P_SYNC_DEPTH; rd_stage = rd_stage+1) begin
+        r_cmd_sync[rd_stage] <= r_cmd_sync[rd_stage-1];
+      end
+      if (w_rd_snap == 1'b1) begin
+        r_reads_snap      <= r_reads;
+        r_rd_stalls_snap  <= r_rd_stalls;
+        r_underflows_snap <= r_underflows;
+      end
+      if (w_rd_clear == 1'b1) begin
+        r_reads      <= 32'h0;
+        r_rd_stalls  <= 32'h0;
+        r_underflows <= 32'h0;
+      end
+      else begin
+        r_reads      <= sat_inc(r_reads, i_rd_accept);
+        r_rd_stalls  <= sat_inc(r_rd_stalls, i_rd_stall);
+        r_underflows <= sat_inc(r_underflows, w_underflow);
+      end
+    end
+  end // rd_count_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  CSR Process
+  // Description : Registered read data, ACK one clock after the strobe.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_wr_clk) begin : csr_proc
+    if (i_wr_rst == 1'b1 || i_csr_cyc == 1'b0) begin
+      r_csr_ack  <= 1'b0;
+      r_csr_data <= 32'h0;
+    end
+    else begin
+      r_csr_ack <= i_csr_stb;
+      case (i_csr_adr)
+        L_CTRL       : r_csr_data <= {31'h0, w_busy};
+        L_WRITES     : r_csr_data <= r_writes_snap;
+        L_READS      : r_csr_data <= r_reads_snap;
+        L_WR_STALLS  : r_csr_data <= r_wr_stalls_snap;
+        L_RD_STALLS  : r_csr_data <= r_rd_stalls_snap;
+        L_HIGH_WATER : r_csr_data <= {{(31-P_LEVEL_MSB){1'b0}}, r_high_water_snap};
+        L_OVERFLOWS  : r_csr_data <= r_overflows_snap;
+        default      : r_csr_data <= r_underflows_snap;
+      endcase
+    end
+  end // csr_proc
+  //
+  assign o_csr_ack   = r_csr_ack;
+  assign o_csr_data  = r_csr_data;
+  assign o_csr_stall = 1'b0;
+
+endmodule // wb4_fifo_stats
@@ -0,0 +1,112 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_gearbox_pack.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_gearbox_pack
+Description  : Wishbone B4(pipelined) write port gearbox, packs narrow input
+               words into wider FIFO words of any width.
+
+Additional Comments:
+   The input bits are appended to an accumulator from the LSB. The beat that
+   brings it to a whole output word pushes that word into the FIFO on the
+   same clock, the bits left over start the next one. Every input beat is
+   taken on the clock it is strobed unless it completes a word the FIFO
+   can't take, so a 24 to 32 port pushes 3 words every 4 beats with no idle
+   clocks. Bits short of a whole word wait for the next beats.
+   The beats are acked here, the FIFO ACKs are not used.
+*/
+module wb4_gearbox_pack #(
+  parameter integer P_DATA_I_MSB = 23, // Input Width-1
+  parameter integer P_DATA_O_MSB = 31  // Output Width-1, wider than the input
+)(
+  input i_clk, // clock
+  input i_rst, // reset
+  // Master Side
+  input                   i_cyc,   // Cycle
+  input                   i_stb,   // Strobe
+  input  [P_DATA_I_MSB:0] i_data,  // Write Data
+  output                  o_ack,   // Acknowledge
+  output                  o_stall, // The beat completes a word the FIFO can't take
+  // FIFO Side
+  output                  o_cyc,   // Cycle
+  output                  o_stb,   // Push a whole word
+  output [P_DATA_O_MSB:0] o_data,  // Whole word
+  input                   i_stall  // FIFO full
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_DATA_I_WIDTH = P_DATA_I_MSB+1;
+  localparam integer L_DATA_O_WIDTH = P_DATA_O_MSB+1;
+  // Up to L_DATA_O_WIDTH-1 bits held plus one input word
+  localparam integer L_ACC_MSB  = L_DATA_I_WIDTH+L_DATA_O_WIDTH-2;
+  localparam integer L_BITS_MSB = $clog2(L_ACC_MSB+2)-1;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  reg [L_ACC_MSB:0]  r_acc;  // Bits held, from the LSB, zero above r_bits
+  reg [L_BITS_MSB:0] r_bits; // Bits held
+  reg                r_ack;
+  // The accumulator with the strobed beat appended
+  wire [L_ACC_MSB:0]  w_acc  = r_acc | ({{(L_ACC_MSB+1-L_DATA_I_WIDTH){1'b0}}, i_data} << r_bits);
+  wire [L_BITS_MSB:0] w_bits = r_bits + L_DATA_I_WIDTH;
+  wire                w_word = (w_bits >= L_DATA_O_WIDTH) ? 1'b1 : 1'b0;
+  wire                w_take = i_cyc & i_stb & ~(w_word & i_stall);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Accumulator Process
+  // Description : Appends the beat, drops the word pushed on the same clock.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : acc_proc
+    if (i_rst == 1'b1) begin
+      r_acc  <= 'h0;
+      r_bits <= 'h0;
+    end
+    else if (w_take == 1'b1) begin
+      if (w_word == 1'b1) begin
+        r_acc  <= w_acc >> L_DATA_O_WIDTH;
+        r_bits <= w_bits - L_DATA_O_WIDTH;
+      end
+      else begin
+        r_acc  <= w_acc;
+        r_bits <= w_bits;
+      end
+    end
+  end // acc_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Ack Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : ack_proc
+    if (i_rst == 1'b1 || i_cyc == 1'b0) begin
+      r_ack <= 1'b0;
+    end
+    else begin
+      r_ack <= w_take;
+    end
+  end // ack_proc
+  //
+  assign o_ack   = r_ack;
+  assign o_stall = w_word & i_stall;
+  assign o_cyc   = i_cyc;
+  assign o_stb   = i_cyc & i_stb & w_word;
+  assign o_data  = w_acc[P_DATA_O_MSB:0];
+
+endmodule // wb4_gearbox_pack
@@ -0,0 +1,129 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_gearbox_unpack.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_gearbox_unpack
+Description  : Wishbone B4(pipelined) read port gearbox, splits wide FIFO
+               words into narrower output words of any width.
+
+Additional Comments:
+   The popped FIFO words are appended to an accumulator from the LSB, every
+   read takes the lowest output word worth of bits. The gearbox pops the
+   FIFO on its own while the bits held plus the pops waiting for their ACK
+   leave room for one more word, like wb4_rd_skid_buffer the request only
+   depends on flops. The room covers a FIFO read latency of up to 2 clocks,
+   so a 10 to 8 port reads on every clock and pops 4 words every 5 reads.
+   STALL is set while less than an output word is held, counting the word
+   acked on this clock. The bits held have left the FIFO, they are not in
+   its fill level.
+*/
+module wb4_gearbox_unpack #(
+  parameter integer P_DATA_I_MSB = 9, // Input Width-1, wider than the output
+  parameter integer P_DATA_O_MSB = 7  // Output Width-1
+)(
+  input i_clk, // clock
+  input i_rst, // reset
+  // Master Side
+  input                   i_cyc,   // Cycle
+  input                   i_stb,   // Strobe
+  output                  o_ack,   // Acknowledge
+  output [P_DATA_O_MSB:0] o_data,  // Registered Read Data
+  output                  o_stall, // Less than a word held
+  // FIFO Side
+  output                  o_cyc,   // Cycle
+  output                  o_stb,   // Pop
+  input                   i_stall, // FIFO empty
+  input                   i_ack,   // Popped word is on i_data
+  input  [P_DATA_I_MSB:0] i_data   // Read Data
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_DATA_I_WIDTH = P_DATA_I_MSB+1;
+  localparam integer L_DATA_O_WIDTH = P_DATA_O_MSB+1;
+  // Two FIFO words in flight on top of what a read may be waiting on
+  localparam integer L_ACC_WIDTH = 2*(L_DATA_I_WIDTH+L_DATA_O_WIDTH);
+  localparam integer L_ACC_MSB   = L_ACC_WIDTH-1;
+  localparam integer L_BITS_MSB  = $clog2(L_ACC_WIDTH+1)-1;
+  localparam integer L_CNT_MSB   = 2;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  reg [L_ACC_MSB:0]    r_acc;      // Bits held, from the LSB, zero above r_bits
+  reg [L_BITS_MSB:0]   r_bits;     // Bits held
+  reg [L_CNT_MSB:0]    r_inflight; // Pops not acked yet
+  reg                  r_ack;
+  reg [P_DATA_O_MSB:0] r_data;
+  // The accumulator with the word acked on this clock appended
+  wire [L_ACC_MSB:0]  w_acc   = (i_ack == 1'b1) ?
+                                r_acc | ({{(L_ACC_WIDTH-L_DATA_I_WIDTH){1'b0}}, i_data} << r_bits) : r_acc;
+  wire [L_BITS_MSB:0] w_avail = r_bits + ((i_ack == 1'b1) ? L_DATA_I_WIDTH : 0);
+  wire                w_ready = (w_avail >= L_DATA_O_WIDTH) ? 1'b1 : 1'b0;
+  wire                w_take  = i_cyc & i_stb & w_ready;
+  // Pop while what is held and in flight leaves room for one more word
+  wire w_req = ((r_bits + r_inflight*L_DATA_I_WIDTH + L_DATA_I_WIDTH) <= L_ACC_WIDTH) ? 1'b1 : 1'b0;
+  wire w_pop = w_req & ~i_stall;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Accumulator Process
+  // Description : Appends the acked word, drops the word read on this clock.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : acc_proc
+    if (i_rst == 1'b1) begin
+      r_acc      <= 'h0;
+      r_bits     <= 'h0;
+      r_inflight <= 'h0;
+    end
+    else begin
+      r_inflight <= r_inflight + {{L_CNT_MSB{1'b0}}, w_pop} - {{L_CNT_MSB{1'b0}}, i_ack};
+      if (w_take == 1'b1) begin
+        r_acc  <= w_acc >> L_DATA_O_WIDTH;
+        r_bits <= w_avail - L_DATA_O_WIDTH;
+      end
+      else begin
+        r_acc  <= w_acc;
+        r_bits <= w_avail;
+      end
+    end
+  end // acc_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read Data Process
+  // Description : Registers the word read, ack on the following clock.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : read_data_proc
+    if (i_rst == 1'b1 || i_cyc == 1'b0) begin
+      r_ack <= 1'b0;
+    end
+    else begin
+      r_ack <= w_take;
+    end
+    if (w_take == 1'b1) begin
+      r_data <= w_acc[P_DATA_O_MSB:0];
+    end
+  end // read_data_proc
+  //
+  assign o_ack   = r_ack;
+  assign o_data  = r_data;
+  assign o_stall = ~w_ready;
+  // Keep CYC up until the pops in flight are acked, the FIFO drops them otherwise.
+  assign o_cyc   = w_req | (r_inflight != 0);
+  assign o_stb   = w_req;
+
+endmodule // wb4_gearbox_unpack
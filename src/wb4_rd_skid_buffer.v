@@ -0,0 +1,167 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_rd_skid_buffer.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_rd_skid_buffer
+Description  : Wishbone B4(pipelined) read port skid buffer, registered STALL
+               and DAT behind a FIFO read port.
+
+Additional Comments:
+   The buffer pops the FIFO on its own, as long as the words it holds plus
+   the pops still waiting for their ACK fit in its 4 entries, so the request
+   only depends on flops. The master is served from the buffer: STALL is
+   registered from the next state word count and the word is registered
+   with the ACK on the clock after the strobe. With a one clock FIFO read
+   latency the buffer keeps up with a read on every clock.
+   The words held here have left the FIFO, they are not in its fill level.
+   P_PIPE_STAGES adds that many registers on the FIFO ACK and DAT before the
+   buffer, for a FIFO far from its reader. The buffer grows with them so the
+   pops in flight still cover the round trip, one word per clock holds for a
+   FIFO read latency of up to 2 clocks.
+*/
+module wb4_rd_skid_buffer #(
+  parameter integer P_DATA_MSB    = 7, // Data Width-1
+  parameter integer P_PIPE_STAGES = 0  // Registers between the FIFO and the buffer
+)(
+  input i_clk, // clock
+  input i_rst, // reset
+  // Master Side
+  input                 i_cyc,   // Cycle
+  input                 i_stb,   // Strobe
+  output                o_ack,   // Acknowledge
+  output [P_DATA_MSB:0] o_data,  // Registered Read Data
+  output                o_stall, // Registered Stall
+  // FIFO Side
+  output                o_cyc,    // Cycle
+  output                o_stb,    // Strobe
+  input                 i_accept, // The FIFO took the pop this clock
+  input                 i_ack,    // Popped word is on i_data
+  input  [P_DATA_MSB:0] i_data    // Read Data
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_ENTRIES = 2**$clog2(P_PIPE_STAGES+4);
+  localparam integer L_IDX_MSB = $clog2(L_ENTRIES)-1;
+  localparam integer L_CNT_MSB = L_IDX_MSB+1;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  reg  [P_DATA_MSB:0] r_buf [0:L_ENTRIES-1];
+  reg  [L_IDX_MSB:0]  r_head;
+  reg  [L_IDX_MSB:0]  r_tail;
+  reg  [L_CNT_MSB:0]  r_count;    // Words held
+  reg  [L_CNT_MSB:0]  r_inflight; // Pops waiting for their ACK
+  reg                 r_stall;
+  reg                 r_ack;
+  reg  [P_DATA_MSB:0] r_data;
+  wire                w_buf_ack;  // ACK out of the pipeline stages
+  wire [P_DATA_MSB:0] w_buf_data; // DAT out of the pipeline stages
+  //
+  wire                w_req        = ((r_count + r_inflight) < L_ENTRIES) ? 1'b1 : 1'b0;
+  wire                w_pop        = i_cyc & i_stb & ~r_stall;
+  wire [L_CNT_MSB:0]  w_count_next = r_count + {{L_CNT_MSB{1'b0}}, w_buf_ack} - {{L_CNT_MSB{1'b0}}, w_pop};
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  generate
+    if (P_PIPE_STAGES == 0) begin: no_pipe_gen
+      assign w_buf_ack  = i_ack;
+      assign w_buf_data = i_data;
+    end // no_pipe_gen
+    else begin: pipe_gen
+      reg                r_pipe_ack  [0:P_PIPE_STAGES-1];
+      reg [P_DATA_MSB:0] r_pipe_data [0:P_PIPE_STAGES-1];
+      integer stage;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  Pipeline Process
+      // Description : The FIFO ACK and DAT move through together, the pops in
+      //               flight count them until they reach the buffer.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin : pipe_proc
+        if (i_rst == 1'b1) begin
+          for (stage = 0; stage < P_PIPE_STAGES; stage = stage+1) begin
+            r_pipe_ack[stage]  <= 1'b0;
+            r_pipe_data[stage] <= 0;
+          end
+        end
+        else begin
+          r_pipe_ack[0]  <= i_ack;
+          r_pipe_data[0] <= i_data;
+          for (stage = 1; stage < P_PIPE_STAGES; stage = stage+1) begin
+            r_pipe_ack[stage]  <= r_pipe_ack[stage-1];
+            r_pipe_data[stage] <= r_pipe_data[stage-1];
+          end
+        end
+      end // pipe_proc
+      //
+      assign w_buf_ack  = r_pipe_ack[P_PIPE_STAGES-1];
+      assign w_buf_data = r_pipe_data[P_PIPE_STAGES-1];
+    end // pipe_gen
+  endgenerate
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Buffer Process
+  // Description : Words come in with the FIFO ACK and leave on a master pop.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : buffer_proc
+    if (i_rst == 1'b1) begin
+      r_head     <= 'h0;
+      r_tail     <= 'h0;
+      r_count    <= 'h0;
+      r_inflight <= 'h0;
+      r_stall    <= 1'b1;
+      r_data     <= 0;
+    end
+    else begin
+      if (w_buf_ack == 1'b1) begin
+        r_buf[r_tail] <= w_buf_data;
+        r_tail        <= r_tail + 1;
+      end
+      if (w_pop == 1'b1) begin
+        r_data <= r_buf[r_head];
+        r_head <= r_head + 1;
+      end
+      r_count    <= w_count_next;
+      r_inflight <= r_inflight + {{L_CNT_MSB{1'b0}}, (w_req & i_accept)} - {{L_CNT_MSB{1'b0}}, w_buf_ack};
+      r_stall    <= (w_count_next == 0) ? 1'b1 : 1'b0;
+    end
+  end // buffer_proc
+  //
+  assign o_stall = r_stall;
+  assign o_data  = r_data;
+  // CYC is held while pops are in flight, the FIFO drops its ACKs without it.
+  assign o_cyc   = w_req | (r_inflight != 0);
+  assign o_stb   = w_req;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read ACK Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : ack_proc
+    if (i_rst == 1'b1 || i_cyc == 1'b0) begin
+      r_ack <= 1'b0;
+    end
+    else begin
+      r_ack <= w_pop;
+    end
+  end // ack_proc
+  //
+  assign o_ack = r_ack;
+
+endmodule // wb4_rd_skid_buffer
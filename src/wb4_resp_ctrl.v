@@ -0,0 +1,94 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_resp_ctrl.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_resp_ctrl
+Description  : Wishbone B4(pipelined) non-blocking response for one FIFO port,
+               a strobe the FIFO would stall is terminated with RTY or ERR.
+
+Additional Comments:
+   Sits on the master side of a FIFO port and watches its STALL and ACK. A
+   strobe the port can't take (full or empty) is not passed on, it is
+   answered one clock later with RTY (P_RESP=1) or ERR
+   (P_RESP=2) so the master can move on to other slaves and come back later.
+   Responses of a pipelined cycle must come back in order, so a refused
+   strobe waits (STALL) only until the ACKs of the strobes the port already
+   took are out, a clock or two, never for the FIFO to change state. The
+   clock of the RTY/ERR is stalled as well, the strobe is kept from the FIFO
+   on that clock, so a zero wait state ACK can't land on it.
+   Dropping CYC clears the outstanding count, the FIFO drops its ACKs too.
+*/
+module wb4_resp_ctrl #(
+  parameter integer P_RESP = 1 // 1=RTY, 2=ERR
+)(
+  input i_clk, // clock
+  input i_rst, // reset
+  // Master Side
+  input  i_cyc,   // Cycle
+  input  i_stb,   // Strobe
+  output o_stall, // Stall, only while earlier responses are outstanding
+  output o_err,   // Refused, P_RESP=2
+  output o_rty,   // Refused, P_RESP=1
+  // FIFO Side
+  output o_stb,   // Strobe
+  input  i_stall, // The FIFO port can't take the strobe
+  input  i_ack    // The FIFO port acked an earlier strobe
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  reg [2:0] r_pending;
+  reg       r_refused;
+  //
+  wire w_accept  = i_cyc & i_stb & ~r_refused & ~i_stall;
+  wire w_drained = (r_pending == 3'd0 || (r_pending == 3'd1 && i_ack == 1'b1)) ? 1'b1 : 1'b0;
+  wire w_refuse  = i_cyc & i_stb & ~r_refused & i_stall & w_drained;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Pending ACK Process
+  // Description : Strobes taken by the FIFO port and not acked yet.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : pending_proc
+    if (i_rst == 1'b1 || i_cyc == 1'b0) begin
+      r_pending <= 3'd0;
+    end
+    else begin
+      r_pending <= r_pending + {2'b00, w_accept} - {2'b00, i_ack};
+    end
+  end // pending_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Refuse Process
+  // Description : Terminates the refused strobe on the next clock, in the
+  //               slot an ACK would have taken.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : refuse_proc
+    if (i_rst == 1'b1 || i_cyc == 1'b0) begin
+      r_refused <= 1'b0;
+    end
+    else begin
+      r_refused <= w_refuse;
+    end
+  end // refuse_proc
+  //
+  assign o_stb   = i_stb & ~r_refused;
+  assign o_stall = (i_stall & ~w_drained) | r_refused;
+  assign o_err   = (P_RESP == 2) ? r_refused : 1'b0;
+  assign o_rty   = (P_RESP == 1) ? r_refused : 1'b0;
+
+endmodule // wb4_resp_ctrl
@@ -16,14 +16,44 @@ Module Name  : wb4_sync_fifo
 Description  : Wishbone B4(pipelined) sync clock FIFO Top Wrapper
 
 Additional Comments:
-   
+   i_wb4_in_flush only applies to the N to 1 FIFO, it closes the output word
+   being packed so a trailing partial word becomes readable. Tie it to 0
+   otherwise.
+   The peek port (P_PEEK=1, 1 to 1 only) reads the entry ADR places past the
+   FIFO head without popping it, a write to it skips ADR entries. The words
+   already popped into the read pipeline are not counted, see
+   wb4_sync_fifo_1_to_1.
+   P_LANES>1 moves up to P_LANES words per clock on each port through
+   wb4_sync_fifo_multi_lane. DAT carries P_LANES words of
+   (P_DATA_I_MSB+1)/P_LANES bits, lane 0 in the LSBs, i_wb4_in_scount and
+   i_wb4_out_scount give the words in each beat and o_wb4_out_savail how many
+   a read beat could pop now. Without lanes the counts are ignored and
+   o_wb4_out_savail is 1 while a word can be read.
+   P_CHANNELS>1 splits the memory in P_CHANNELS queues of P_DEPTH/P_CHANNELS
+   words through wb4_sync_fifo_multi_queue. i_wb4_in_schan/i_wb4_out_schan
+   pick the queue of every beat and can change on every clock, STALL, the
+   levels and the almost flags are those of the selected queue.
 */
 module wb4_sync_fifo #(
   parameter integer P_DATA_I_MSB = 7,            // FIFO Width-1
   parameter integer P_DATA_O_MSB = P_DATA_I_MSB, // FIFO Width-1
-  parameter integer P_DEPTH      = 128,          // FIFO $clog2(Depth)-1
+  parameter integer P_DEPTH      = 128,          // FIFO Depth, any value
   parameter integer P_USE_BRAM   = 1,            // BRAM of LUT based
-  parameter integer P_MASK_MSB   = P_DATA_O_MSB  // P_DATA_O_MSB=bit, (P_DATA_O_MSB+1)/4=nibble...
+  parameter integer P_MASK_MSB   = P_DATA_O_MSB, // P_DATA_O_MSB=bit, (P_DATA_O_MSB+1)/4=nibble...
+  parameter integer P_FWFT       = 0,            // 1=First-Word-Fall-Through read port (1 to 1 only)
+  parameter integer P_SKID_BUFFER = 0,           // 1=Registered STALL/DAT on both ports (N to 1 only)
+  parameter integer P_BANK_DEPTH  = 0,           // 0=One memory, else BRAM bank depth (power of 2)
+  parameter integer P_NB_RESP     = 0,           // Full/empty strobes: 0=STALL, 1=RTY, 2=ERR
+  parameter integer P_STATS       = 0,           // 1=Statistics counters on the CSR port
+  parameter integer P_RD_PIPE_STAGES = 0,        // Extra registers on the read DAT/ACK/STALL
+  parameter integer P_BYPASS      = 0,           // 1=Empty FIFO write to read bypass (1 to 1 only)
+  parameter integer P_PEEK        = 0,           // 1=Look-ahead read and skip port (1 to 1 only)
+  parameter integer P_LANES       = 1,           // Words per clock on both ports, power of 2 (1 to 1 only)
+  parameter integer P_CHANNELS    = 1,           // Queues sharing the memory, power of 2 up to 256 (1 to 1 only)
+  // Fill Level Params, in stored words (the wider of the two widths)
+  parameter integer P_ALMOST_FULL  = (P_DEPTH*3)/4, // Almost Full when level >= P_ALMOST_FULL
+  parameter integer P_ALMOST_EMPTY = P_DEPTH/4,     // Almost Empty when level <= P_ALMOST_EMPTY
+  parameter integer P_PROG_THRESH  = 0              // 1=Use the threshold input ports instead
 )(
   // Component's clocks and resets
   input i_clk, // clock
@@ -34,12 +64,47 @@ module wb4_sync_fifo #(
   output                  o_wb4_in_sack,   // Write Strobe
   input  [P_DATA_I_MSB:0] i_wb4_in_sdata,  // Write Data
   output                  o_wb4_in_sstall, // Full?
+  output                  o_wb4_in_serr,   // Written while full, P_NB_RESP=2
+  output                  o_wb4_in_srty,   // Written while full, P_NB_RESP=1
+  input                   i_wb4_in_flush,  // Close a partial output word (N to 1 only)
+  input  [$clog2(P_DEPTH):0] i_wb4_in_scount, // Words in this beat, P_LANES>1
+  input  [7:0]            i_wb4_in_schan,  // Queue to write, P_CHANNELS>1
+  // Write Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Runtime threshold, P_PROG_THRESH=1
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
   // Read Interface Signals
   input                   i_wb4_out_scyc,   // Read Strobe
   input                   i_wb4_out_sstb,   // Read Strobe
   output                  o_wb4_out_sack,   // Write Strobe
   output [P_DATA_O_MSB:0] o_wb4_out_sdata,  // Read Data
-  output                  o_wb4_out_sstall  // Empty?
+  output                  o_wb4_out_sstall, // Empty?
+  output                  o_wb4_out_serr,   // Read while empty, P_NB_RESP=2
+  output                  o_wb4_out_srty,   // Read while empty, P_NB_RESP=1
+  input  [$clog2(P_DEPTH):0] i_wb4_out_scount, // Words to pop in this beat, P_LANES>1
+  output [$clog2(P_DEPTH):0] o_wb4_out_savail, // Words a beat could pop now
+  input  [7:0]            i_wb4_out_schan,  // Queue to read, P_CHANNELS>1
+  // Read Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Runtime threshold, P_PROG_THRESH=1
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level,         // Entries in use
+  // Peek Interface Signals, P_PEEK=1
+  input                      i_wb4_peek_scyc,  // Cycle
+  input                      i_wb4_peek_sstb,  // Strobe
+  input                      i_wb4_peek_swe,   // 0=Read head+ADR, 1=Skip ADR entries
+  input  [$clog2(P_DEPTH):0] i_wb4_peek_sadr,  // Entries past the head
+  output                     o_wb4_peek_sack,  // Acknowledge
+  output [P_DATA_O_MSB:0]    o_wb4_peek_sdata,  // Entry at head+ADR
+  output                     o_wb4_peek_sstall, // Not that many entries stored
+  // Statistics CSR Interface, P_STATS=1
+  input                   i_wb4_csr_scyc,   // Cycle
+  input                   i_wb4_csr_sstb,   // Strobe
+  input                   i_wb4_csr_swe,    // Write Enable
+  input  [2:0]            i_wb4_csr_sadr,   // Register
+  input  [31:0]           i_wb4_csr_sdata,  // Write Data
+  output                  o_wb4_csr_sack,   // Acknowledge
+  output [31:0]           o_wb4_csr_sdata,  // Read Data
+  output                  o_wb4_csr_sstall  // Never stalls
 );
 
 /*verilator coverage_off*/
@@ -53,14 +118,14 @@ module wb4_sync_fifo #(
   //     and create reports.
   ///////////////////////////////////////////////////////////////////////////////
   initial begin
-    if(P_DATA_I_MSB > P_DATA_O_MSB) begin
-      $display("[COMPILE-ERROR]");
+    if(((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) != 0 && ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0) begin
+      $display("[COMPILE-NOTICE]");
       $display("  source: wb4_sync_fifo");
-      $display("  type: Parameter");
+      $display("  type: Infered Logic");
       $display("  parameters:");
       $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
       $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
-      $display("  description: P_DATA_O_MSB can't be samller than P_DATA_I_MSB.");
+      $display("  description: The widths are not multiples of each other, generating a %0d to %0d gearbox FIFO.", P_DATA_I_MSB+1, P_DATA_O_MSB+1);
     end
 
     if(P_MASK_MSB > P_DATA_O_MSB) begin
@@ -82,7 +147,139 @@ module wb4_sync_fifo #(
       $display("  description: Inferring LUTs instead of BRAM for FIFO space.");
     end
 
-    if(P_DATA_I_MSB < P_DATA_O_MSB) begin
+    if(P_BANK_DEPTH != 0 && ((P_BANK_DEPTH & (P_BANK_DEPTH-1)) != 0 || P_BANK_DEPTH > P_DEPTH)) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_BANK_DEPTH: %0d", P_BANK_DEPTH);
+      $display("    P_DEPTH: %0d", P_DEPTH);
+      $display("  description: P_BANK_DEPTH must be a power of 2 no larger than P_DEPTH.");
+    end
+
+    if(P_NB_RESP > 2) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_NB_RESP: %0d", P_NB_RESP);
+      $display("  description: P_NB_RESP must be 0 (STALL), 1 (RTY) or 2 (ERR).");
+    end
+
+    if(P_FWFT == 1 && P_DATA_I_MSB != P_DATA_O_MSB) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_FWFT: %0d", P_FWFT);
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: FWFT is only available on the 1 to 1 FIFO, ignoring P_FWFT.");
+    end
+
+    if(P_BYPASS == 1 && (P_FWFT == 1 || P_DATA_I_MSB != P_DATA_O_MSB)) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_BYPASS: %0d", P_BYPASS);
+      $display("    P_FWFT: %0d", P_FWFT);
+      $display("  description: The bypass is only available on the 1 to 1 FIFO standard read port, ignoring P_BYPASS.");
+    end
+
+    if(P_PEEK == 1 && P_DATA_I_MSB != P_DATA_O_MSB) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_PEEK: %0d", P_PEEK);
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: The peek port is only available on the 1 to 1 FIFO, ignoring P_PEEK.");
+    end
+
+    if(P_PEEK == 1 && P_RD_PIPE_STAGES != 0) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_PEEK: %0d", P_PEEK);
+      $display("    P_RD_PIPE_STAGES: %0d", P_RD_PIPE_STAGES);
+      $display("  description: The peek port counts from the FIFO head, the words held in the read pipeline come before it.");
+    end
+
+    if(P_FWFT == 1 && P_RD_PIPE_STAGES != 0) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_FWFT: %0d", P_FWFT);
+      $display("    P_RD_PIPE_STAGES: %0d", P_RD_PIPE_STAGES);
+      $display("  description: The read pipeline registers the read port, reads ack one clock after the strobe.");
+    end
+
+    if(P_RD_PIPE_STAGES != 0 && P_LANES <= 1 && P_CHANNELS <= 1) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_RD_PIPE_STAGES: %0d", P_RD_PIPE_STAGES);
+      $display("  description: The read pipeline pops the FIFO ahead of the master. The words it prefetched are not in the level, the almost empty flag nor the statistics.");
+    end
+
+    if(P_LANES > 1 && (P_DATA_I_MSB != P_DATA_O_MSB || ((P_DATA_I_MSB+1)%P_LANES) != 0)) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_LANES: %0d", P_LANES);
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: The lanes need equal port widths holding P_LANES words each.");
+    end
+
+    if(P_LANES > 1 && (P_FWFT == 1 || P_BYPASS == 1 || P_PEEK == 1 || P_RD_PIPE_STAGES != 0 || P_USE_BRAM == 0 || P_BANK_DEPTH != 0)) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_LANES: %0d", P_LANES);
+      $display("  description: The multi lane FIFO has one BRAM per lane and a plain read port, ignoring P_FWFT, P_BYPASS, P_PEEK, P_RD_PIPE_STAGES, P_USE_BRAM and P_BANK_DEPTH.");
+    end
+
+    if(P_CHANNELS > 1 && (P_DATA_I_MSB != P_DATA_O_MSB || P_LANES > 1 || P_CHANNELS > 256 ||
+                          (P_CHANNELS & (P_CHANNELS-1)) != 0 || (P_DEPTH & (P_DEPTH-1)) != 0 || P_DEPTH < 2*P_CHANNELS)) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_CHANNELS: %0d", P_CHANNELS);
+      $display("    P_DEPTH: %0d", P_DEPTH);
+      $display("    P_LANES: %0d", P_LANES);
+      $display("  description: The queues need a 1 to 1 FIFO without lanes, P_CHANNELS and P_DEPTH powers of 2, P_CHANNELS <= 256 and P_DEPTH >= 2*P_CHANNELS.");
+    end
+
+    if(P_CHANNELS > 1 && (P_FWFT == 1 || P_BYPASS == 1 || P_PEEK == 1 || P_RD_PIPE_STAGES != 0 || P_USE_BRAM == 0 || P_BANK_DEPTH != 0)) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_CHANNELS: %0d", P_CHANNELS);
+      $display("  description: The queues share one BRAM with a plain read port, ignoring P_FWFT, P_BYPASS, P_PEEK, P_RD_PIPE_STAGES, P_USE_BRAM and P_BANK_DEPTH.");
+    end
+
+    if(P_SKID_BUFFER == 1 && (P_DATA_I_MSB >= P_DATA_O_MSB || ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0)) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_SKID_BUFFER: %0d", P_SKID_BUFFER);
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: The skid buffers are only available on the N to 1 FIFO, ignoring P_SKID_BUFFER.");
+    end
+
+    if(P_DATA_I_MSB < P_DATA_O_MSB && ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) == 0) begin
       $display("[COMPILE-NOTICE]");
       $display("  source: wb4_sync_fifo");
       $display("  type: Infered Logic");
@@ -91,45 +288,341 @@ module wb4_sync_fifo #(
       $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
       $display("  description: Generating an %0d to 1 FIFO.", ((P_DATA_O_MSB+1)/(P_DATA_I_MSB+1)));
     end
+
+    if(P_DATA_I_MSB > P_DATA_O_MSB && ((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) == 0) begin
+      $display("[COMPILE-NOTICE]");
+      $display("  source: wb4_sync_fifo");
+      $display("  type: Infered Logic");
+      $display("  parameters:");
+      $display("    P_DATA_I_MSB: %0d", P_DATA_I_MSB);
+      $display("    P_DATA_O_MSB: %0d", P_DATA_O_MSB);
+      $display("  description: Generating a 1 to %0d FIFO.", ((P_DATA_I_MSB+1)/(P_DATA_O_MSB+1)));
+    end
   end
 /*verilator coverage_on*/
 
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_LEVEL_MSB = $clog2(P_DEPTH);
+  // Neither width a multiple of the other, see gearbox_fifo_gen.
+  localparam integer L_GEARBOX   = (((P_DATA_I_MSB+1)%(P_DATA_O_MSB+1)) != 0 &&
+                                    ((P_DATA_O_MSB+1)%(P_DATA_I_MSB+1)) != 0) ? 1 : 0;
+  // Several words per clock, see multi_lane_fifo_gen.
+  localparam integer L_MULTI_LANE = (P_LANES > 1 && P_DATA_I_MSB == P_DATA_O_MSB) ? 1 : 0;
+  localparam integer L_LANE_MSB   = ((P_DATA_I_MSB+1)/P_LANES)-1;
+  // Queues sharing the memory, see multi_queue_fifo_gen.
+  localparam integer L_MULTI_QUEUE = (P_CHANNELS > 1 && P_DATA_I_MSB == P_DATA_O_MSB && L_MULTI_LANE == 0) ? 1 : 0;
+  localparam integer L_CH_MSB      = (P_CHANNELS > 1) ? $clog2(P_CHANNELS)-1 : 0;
+  localparam integer L_CH_DEPTH    = (P_CHANNELS > 1) ? P_DEPTH/P_CHANNELS : P_DEPTH;
+  localparam integer L_CH_LEVEL_W  = $clog2(L_CH_DEPTH)+1;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Almost Full/Empty thresholds, compile time or runtime programmable.
+  wire [L_LEVEL_MSB:0] w_afull_thresh  = (P_PROG_THRESH == 1) ? i_wb4_in_afull_thresh   : P_ALMOST_FULL;
+  wire [L_LEVEL_MSB:0] w_aempty_thresh = (P_PROG_THRESH == 1) ? i_wb4_out_aempty_thresh : P_ALMOST_EMPTY;
+  // Master side strobes and FIFO side stalls, see nb_resp_gen.
+  wire w_in_stb;
+  wire w_in_stall;
+  wire w_out_stb;
+  wire w_out_stall;
+  wire w_out_nb_err;
+  // FIFO read port, behind the read pipeline, see rd_pipe_gen.
+  wire                  w_fifo_rd_cyc;
+  wire                  w_fifo_rd_stb;
+  wire                  w_fifo_rd_ack;
+  wire [P_DATA_O_MSB:0] w_fifo_rd_data;
+  wire                  w_fifo_rd_stall;
+  // Lane counts clamped to P_LANES, see multi_lane_fifo_gen.
+  wire [$clog2(P_LANES):0] w_in_count  = (i_wb4_in_scount > P_LANES) ? P_LANES : i_wb4_in_scount;
+  wire [$clog2(P_LANES):0] w_out_count = (i_wb4_out_scount > P_LANES) ? P_LANES : i_wb4_out_scount;
+  wire [$clog2(P_LANES):0] w_out_avail;
+
   ///////////////////////////////////////////////////////////////////////////////
   //            ********      Architecture Declaration      ********           //
   ///////////////////////////////////////////////////////////////////////////////
-  
+
+  generate
+  if (P_NB_RESP == 0) begin: stall_resp_gen
+    // Full/empty stall the master.
+    assign w_in_stb         = i_wb4_in_sstb;
+    assign o_wb4_in_sstall  = w_in_stall;
+    assign o_wb4_in_serr    = 1'b0;
+    assign o_wb4_in_srty    = 1'b0;
+    assign w_out_stb        = i_wb4_out_sstb;
+    assign o_wb4_out_sstall = w_out_stall;
+    assign w_out_nb_err     = 1'b0;
+    assign o_wb4_out_srty   = 1'b0;
+  end // stall_resp_gen
+  else begin: nb_resp_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Write Port Response Control
+  // Description : A write to a full FIFO is terminated with RTY/ERR.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_resp_ctrl #(
+    .P_RESP(P_NB_RESP)
+  ) wr_resp_ctrl_inst (
+    .i_clk  (i_clk          ),
+    .i_rst  (i_rst          ),
+    .i_cyc  (i_wb4_in_scyc  ),
+    .i_stb  (i_wb4_in_sstb  ),
+    .o_stall(o_wb4_in_sstall),
+    .o_err  (o_wb4_in_serr  ),
+    .o_rty  (o_wb4_in_srty  ),
+    .o_stb  (w_in_stb       ),
+    .i_stall(w_in_stall     ),
+    .i_ack  (o_wb4_in_sack  )
+  );
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Read Port Response Control
+  // Description : A read from an empty FIFO is terminated with RTY/ERR.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_resp_ctrl #(
+    .P_RESP(P_NB_RESP)
+  ) rd_resp_ctrl_inst (
+    .i_clk  (i_clk           ),
+    .i_rst  (i_rst           ),
+    .i_cyc  (i_wb4_out_scyc  ),
+    .i_stb  (i_wb4_out_sstb  ),
+    .o_stall(o_wb4_out_sstall),
+    .o_err  (w_out_nb_err    ),
+    .o_rty  (o_wb4_out_srty  ),
+    .o_stb  (w_out_stb       ),
+    .i_stall(w_out_stall     ),
+    .i_ack  (o_wb4_out_sack  )
+  );
+  end // nb_resp_gen
+  endgenerate
+
   generate
-  if (P_DATA_I_MSB == P_DATA_O_MSB) begin: one_to_one_fifo_gen
+  if (P_RD_PIPE_STAGES == 0 || L_MULTI_LANE == 1 || L_MULTI_QUEUE == 1) begin: no_rd_pipe_gen
+    // The read port goes straight to the FIFO.
+    assign w_fifo_rd_cyc   = i_wb4_out_scyc;
+    assign w_fifo_rd_stb   = w_out_stb;
+    assign w_out_stall     = w_fifo_rd_stall;
+    assign o_wb4_out_sack  = w_fifo_rd_ack;
+    assign o_wb4_out_sdata = w_fifo_rd_data;
+  end // no_rd_pipe_gen
+  else begin: rd_pipe_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Read Pipeline
+  // Description : P_RD_PIPE_STAGES registers on the read DAT/ACK, the buffer
+  //               pops the FIFO ahead of the master so STALL stays registered
+  //               and a word per clock goes through.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_rd_skid_buffer #(
+    .P_DATA_MSB   (P_DATA_O_MSB),
+    .P_PIPE_STAGES(P_RD_PIPE_STAGES)
+  ) rd_pipe_inst (
+    .i_clk   (i_clk                           ),
+    .i_rst   (i_rst                           ),
+    // Master Side
+    .i_cyc   (i_wb4_out_scyc                  ),
+    .i_stb   (w_out_stb                       ),
+    .o_ack   (o_wb4_out_sack                  ),
+    .o_data  (o_wb4_out_sdata                 ),
+    .o_stall (w_out_stall                     ),
+    // FIFO Side
+    .o_cyc   (w_fifo_rd_cyc                   ),
+    .o_stb   (w_fifo_rd_stb                   ),
+    .i_accept(w_fifo_rd_stb & ~w_fifo_rd_stall),
+    .i_ack   (w_fifo_rd_ack                   ),
+    .i_data  (w_fifo_rd_data                  )
+  );
+  end // rd_pipe_gen
+  endgenerate
+
+  generate
+  if (P_STATS == 1) begin: stats_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : FIFO Statistics
+  // Description : Counters behind the CSR port, on the FIFO clock.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_fifo_stats #(
+    .P_LEVEL_MSB (L_LEVEL_MSB),
+    .P_SYNC_DEPTH(1)
+  ) wb4_fifo_stats_inst (
+    // Write Domain
+    .i_wr_clk    (i_clk                                             ),
+    .i_wr_rst    (i_rst                                             ),
+    .i_wr_accept (i_wb4_in_scyc & w_in_stb & ~w_in_stall            ),
+    .i_wr_stall  (i_wb4_in_scyc & i_wb4_in_sstb & o_wb4_in_sstall   ),
+    .i_wr_refused(o_wb4_in_serr | o_wb4_in_srty                     ),
+    .i_wr_level  (o_wb4_in_level                                    ),
+    // Read Domain
+    .i_rd_clk    (i_clk                                             ),
+    .i_rd_rst    (i_rst                                             ),
+    .i_rd_accept (i_wb4_out_scyc & w_out_stb & ~w_out_stall         ),
+    .i_rd_stall  (i_wb4_out_scyc & i_wb4_out_sstb & o_wb4_out_sstall),
+    .i_rd_refused(w_out_nb_err | o_wb4_out_srty                     ),
+    // CSR Slave Interface
+    .i_csr_cyc   (i_wb4_csr_scyc                                    ),
+    .i_csr_stb   (i_wb4_csr_sstb                                    ),
+    .i_csr_we    (i_wb4_csr_swe                                     ),
+    .i_csr_adr   (i_wb4_csr_sadr                                    ),
+    .i_csr_data  (i_wb4_csr_sdata                                   ),
+    .o_csr_ack   (o_wb4_csr_sack                                    ),
+    .o_csr_data  (o_wb4_csr_sdata                                   ),
+    .o_csr_stall (o_wb4_csr_sstall                                  )
+  );
+  end // stats_gen
+  else begin: no_stats_gen
+    assign o_wb4_csr_sack   = 1'b0;
+    assign o_wb4_csr_sdata  = 32'h0;
+    assign o_wb4_csr_sstall = 1'b0;
+  end // no_stats_gen
+  endgenerate
+
+  assign o_wb4_out_serr = w_out_nb_err;
+
+  generate
+  if (P_DATA_I_MSB == P_DATA_O_MSB && L_MULTI_LANE == 0 && L_MULTI_QUEUE == 0) begin: one_to_one_fifo_gen
   ///////////////////////////////////////////////////////////////////////////////
   // Instance    : WB4 Sync 1 to 1 FIFO
   // Description : 
   ///////////////////////////////////////////////////////////////////////////////
   wb4_sync_fifo_1_to_1 #(
-    .P_DATA_MSB(P_DATA_I_MSB), // FIFO Width-1
-    .P_DEPTH   (P_DEPTH     ), // FIFO $clog2(Depth)-1
-    .P_USE_BRAM(P_USE_BRAM  )  // BRAM of LUT based
+    .P_DATA_MSB  (P_DATA_I_MSB), // FIFO Width-1
+    .P_DEPTH     (P_DEPTH     ), // FIFO $clog2(Depth)-1
+    .P_USE_BRAM  (P_USE_BRAM  ), // BRAM of LUT based
+    .P_FWFT      (P_FWFT      ), // First-Word-Fall-Through
+    .P_BANK_DEPTH(P_BANK_DEPTH), // BRAM bank depth
+    .P_BYPASS    (P_BYPASS    ), // Empty FIFO bypass
+    .P_PEEK      (P_PEEK      )  // Look-ahead read and skip port
   ) wb4_sync_fifo_1_to_1_inst (
     // Component's clocks and resets
     .i_clk(i_clk), // clock
     .i_rst(i_rst), // reset
     // Write Interface  Signals
     .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
-    .i_wb4_in_sstb  (i_wb4_in_sstb  ), // Write Strobe
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
     .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
     .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
-    .o_wb4_in_sstall(o_wb4_in_sstall), // Full?
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
     // Read Interface Signals
-    .i_wb4_out_scyc  (i_wb4_out_scyc  ), // Not Abort / Enable
-    .i_wb4_out_sstb  (i_wb4_out_sstb  ), // Read Strobe
-    .o_wb4_out_sack  (o_wb4_out_sack  ), // Read Acknowledge
-    .o_wb4_out_sdata (o_wb4_out_sdata ), // Read Data
-    .o_wb4_out_sstall(o_wb4_out_sstall)  // Empty?
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       ), // Entries in use
+    // Peek Interface Signals
+    .i_wb4_peek_scyc  (i_wb4_peek_scyc  ), // Cycle
+    .i_wb4_peek_sstb  (i_wb4_peek_sstb  ), // Strobe
+    .i_wb4_peek_swe   (i_wb4_peek_swe   ), // 0=Peek, 1=Skip
+    .i_wb4_peek_sadr  (i_wb4_peek_sadr  ), // Entries past the head
+    .o_wb4_peek_sack  (o_wb4_peek_sack  ), // Acknowledge
+    .o_wb4_peek_sdata (o_wb4_peek_sdata ), // Entry at head+ADR
+    .o_wb4_peek_sstall(o_wb4_peek_sstall)  // Not that many entries stored
   );
   end  // one_to_one_fifo_gen
+  else begin: no_peek_gen
+    assign o_wb4_peek_sack   = 1'b0;
+    assign o_wb4_peek_sdata  = {(P_DATA_O_MSB+1){1'b0}};
+    assign o_wb4_peek_sstall = 1'b1;
+  end // no_peek_gen
   endgenerate
 
   generate
-  if (P_DATA_I_MSB < P_DATA_O_MSB) begin: N_to_one_fifo_gen
+  if (L_MULTI_LANE == 1) begin: multi_lane_fifo_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Sync Multi Lane FIFO
+  // Description : Up to P_LANES words per clock on each port.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_sync_fifo_multi_lane #(
+    .P_DATA_MSB(L_LANE_MSB), // Lane Width-1
+    .P_LANES   (P_LANES   ), // Words per clock
+    .P_DEPTH   (P_DEPTH   )  // FIFO Depth in words
+  ) wb4_sync_fifo_multi_lane_inst (
+    // Component's clocks and resets
+    .i_clk(i_clk), // clock
+    .i_rst(i_rst), // reset
+    // Write Interface  Signals
+    .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
+    .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
+    .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data, lane 0 first
+    .i_wb4_in_scount(w_in_count     ), // Valid lanes in this beat
+    .o_wb4_in_sstall(w_in_stall     ), // Not enough room?
+    .o_wb4_in_level (o_wb4_in_level ), // Entries in use
+    // Read Interface Signals
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Read Cycle
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data, lane 0 first
+    .i_wb4_out_scount(w_out_count     ), // Lanes requested in this beat
+    .o_wb4_out_savail(w_out_avail     ), // Lanes available now
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Not enough words?
+    .o_wb4_out_level (o_wb4_out_level )  // Entries in use
+  );
+  // The level is registered, so are the flags compared against it.
+  assign o_wb4_in_almost_full   = (o_wb4_in_level >= w_afull_thresh) ? 1'b1 : 1'b0;
+  assign o_wb4_out_almost_empty = (o_wb4_out_level <= w_aempty_thresh) ? 1'b1 : 1'b0;
+  assign o_wb4_out_savail       = {{(L_LEVEL_MSB-$clog2(P_LANES)){1'b0}}, w_out_avail};
+  end // multi_lane_fifo_gen
+  else begin: one_lane_gen
+    assign o_wb4_out_savail = {{L_LEVEL_MSB{1'b0}}, ~w_out_stall};
+  end // one_lane_gen
+  endgenerate
+
+  generate
+  if (L_MULTI_QUEUE == 1) begin: multi_queue_fifo_gen
+    // Fill level of every queue, queue 0 in the lowest bits
+    wire [(P_CHANNELS*L_CH_LEVEL_W)-1:0] w_ch_levels;
+    wire [L_CH_LEVEL_W-1:0]              w_in_ch_level  = w_ch_levels[i_wb4_in_schan[L_CH_MSB:0]*L_CH_LEVEL_W +: L_CH_LEVEL_W];
+    wire [L_CH_LEVEL_W-1:0]              w_out_ch_level = w_ch_levels[i_wb4_out_schan[L_CH_MSB:0]*L_CH_LEVEL_W +: L_CH_LEVEL_W];
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Sync Multi Queue FIFO
+  // Description : P_CHANNELS queues in one memory, the channel can change on
+  //               every beat.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_sync_fifo_multi_queue #(
+    .P_DATA_MSB(P_DATA_I_MSB), // FIFO Width-1
+    .P_CHANNELS(P_CHANNELS  ), // Queues
+    .P_CH_DEPTH(L_CH_DEPTH  )  // Depth of every queue
+  ) wb4_sync_fifo_multi_queue_inst (
+    // Component's clocks and resets
+    .i_clk(i_clk), // clock
+    .i_rst(i_rst), // reset
+    // Write Interface  Signals
+    .i_wb4_in_scyc  (i_wb4_in_scyc                 ), // Enable
+    .i_wb4_in_sstb  (w_in_stb                      ), // Write Strobe
+    .o_wb4_in_sack  (o_wb4_in_sack                 ), // Write Acknowledge
+    .i_wb4_in_sdata (i_wb4_in_sdata                ), // Write Data
+    .i_wb4_in_schan (i_wb4_in_schan[L_CH_MSB:0]    ), // Queue to write
+    .o_wb4_in_sstall(w_in_stall                    ), // Selected queue full?
+    .o_wb4_in_full  (                              ), // Full flag per queue
+    // Read Interface Signals
+    .i_wb4_out_scyc  (w_fifo_rd_cyc                ), // Read Cycle
+    .i_wb4_out_sstb  (w_fifo_rd_stb                ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack                ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data               ), // Read Data
+    .i_wb4_out_schan (i_wb4_out_schan[L_CH_MSB:0]  ), // Queue to read
+    .o_wb4_out_sstall(w_fifo_rd_stall              ), // Selected queue empty?
+    .o_wb4_out_empty (                             ), // Empty flag per queue
+    // Fill Level per queue
+    .o_wb4_level(w_ch_levels) // Entries in use
+  );
+  // Levels and flags of the selected queues.
+  assign o_wb4_in_level         = {{(L_LEVEL_MSB+1-L_CH_LEVEL_W){1'b0}}, w_in_ch_level};
+  assign o_wb4_out_level        = {{(L_LEVEL_MSB+1-L_CH_LEVEL_W){1'b0}}, w_out_ch_level};
+  assign o_wb4_in_almost_full   = (o_wb4_in_level >= w_afull_thresh) ? 1'b1 : 1'b0;
+  assign o_wb4_out_almost_empty = (o_wb4_out_level <= w_aempty_thresh) ? 1'b1 : 1'b0;
+  end // multi_queue_fifo_gen
+  endgenerate
+
+  generate
+  if (P_DATA_I_MSB < P_DATA_O_MSB && L_GEARBOX == 0) begin: N_to_one_fifo_gen
   ///////////////////////////////////////////////////////////////////////////////
   // Instance    : WB4 Sync 1 to 1 FIFO
   // Description : 
@@ -138,26 +631,117 @@ module wb4_sync_fifo #(
     .P_DATA_I_MSB(P_DATA_I_MSB), // FIFO Width-1
     .P_DATA_O_MSB(P_DATA_O_MSB), // FIFO Width-1
     .P_DEPTH   (P_DEPTH   ),     // FIFO $clog2(Depth)-1
-    .P_USE_BRAM(1         ),     // BRAM of LUT based
-    .P_MASK_MSB(P_MASK_MSB)      // 
+    .P_USE_BRAM(P_USE_BRAM),     // BRAM of LUT based
+    .P_MASK_MSB(P_MASK_MSB),     // 
+    .P_SKID_BUFFER(P_SKID_BUFFER), // Registered STALL/DAT
+    .P_BANK_DEPTH (P_BANK_DEPTH )  // BRAM bank depth
   ) wwb4_sync_fifo_N_to_1_inst (
     // Component's clocks and resets
     .i_clk(i_clk), // clock
     .i_rst(i_rst), // reset
     // Write Interface  Signals
     .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
-    .i_wb4_in_sstb  (i_wb4_in_sstb  ), // Write Strobe
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
     .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
     .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
-    .o_wb4_in_sstall(o_wb4_in_sstall), // Full?
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    .i_wb4_in_flush (i_wb4_in_flush ), // Close the partial word
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
     // Read Interface Signals
-    .i_wb4_out_scyc  (i_wb4_out_scyc  ), // Not Abort / Enable
-    .i_wb4_out_sstb  (i_wb4_out_sstb  ), // Read Strobe
-    .o_wb4_out_sack  (o_wb4_out_sack  ), // Read Acknowledge
-    .o_wb4_out_sdata (o_wb4_out_sdata ), // Read Data
-    .o_wb4_out_sstall(o_wb4_out_sstall)  // Empty?
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
   );
   end // N_to_one_fifo_gen
   endgenerate
 
+  generate
+  if (P_DATA_I_MSB > P_DATA_O_MSB && L_GEARBOX == 0) begin: one_to_N_fifo_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Sync 1 to N FIFO
+  // Description : Wide input words, narrow output sub-words.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_sync_fifo_1_to_N #(
+    .P_DATA_I_MSB(P_DATA_I_MSB), // FIFO Width-1
+    .P_DATA_O_MSB(P_DATA_O_MSB), // FIFO Width-1
+    .P_DEPTH     (P_DEPTH     ), // FIFO Depth in input words
+    .P_USE_BRAM  (P_USE_BRAM  ), // BRAM of LUT based
+    .P_BANK_DEPTH(P_BANK_DEPTH)  // BRAM bank depth
+  ) wb4_sync_fifo_1_to_N_inst (
+    // Component's clocks and resets
+    .i_clk(i_clk), // clock
+    .i_rst(i_rst), // reset
+    // Write Interface  Signals
+    .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
+    .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
+    .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
+    // Read Interface Signals
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
+  );
+  end // one_to_N_fifo_gen
+  endgenerate
+
+  generate
+  if (L_GEARBOX == 1) begin: gearbox_fifo_gen
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : WB4 Sync Gearbox FIFO
+  // Description : Any input and output widths, e.g. 24 to 32 or 10 to 8.
+  ///////////////////////////////////////////////////////////////////////////////
+  wb4_sync_fifo_gearbox #(
+    .P_DATA_I_MSB(P_DATA_I_MSB), // FIFO Width-1
+    .P_DATA_O_MSB(P_DATA_O_MSB), // FIFO Width-1
+    .P_DEPTH     (P_DEPTH     ), // FIFO Depth in stored (wider) words
+    .P_USE_BRAM  (P_USE_BRAM  ), // BRAM of LUT based
+    .P_BANK_DEPTH(P_BANK_DEPTH)  // BRAM bank depth
+  ) wb4_sync_fifo_gearbox_inst (
+    // Component's clocks and resets
+    .i_clk(i_clk), // clock
+    .i_rst(i_rst), // reset
+    // Write Interface  Signals
+    .i_wb4_in_scyc  (i_wb4_in_scyc  ), // Enable
+    .i_wb4_in_sstb  (w_in_stb       ), // Write Strobe
+    .o_wb4_in_sack  (o_wb4_in_sack  ), // Write Acknowledge
+    .i_wb4_in_sdata (i_wb4_in_sdata ), // Write Data
+    .o_wb4_in_sstall(w_in_stall     ), // Full?
+    // Write Side Fill Level
+    .i_wb4_in_afull_thresh(w_afull_thresh      ), //
+    .o_wb4_in_almost_full (o_wb4_in_almost_full), // Almost Full?
+    .o_wb4_in_level       (o_wb4_in_level      ), // Entries in use
+    // Read Interface Signals
+    .i_wb4_out_scyc  (w_fifo_rd_cyc   ), // Not Abort / Enable
+    .i_wb4_out_sstb  (w_fifo_rd_stb   ), // Read Strobe
+    .o_wb4_out_sack  (w_fifo_rd_ack   ), // Read Acknowledge
+    .o_wb4_out_sdata (w_fifo_rd_data  ), // Read Data
+    .o_wb4_out_sstall(w_fifo_rd_stall ), // Empty?
+    // Read Side Fill Level
+    .i_wb4_out_aempty_thresh(w_aempty_thresh       ), //
+    .o_wb4_out_almost_empty (o_wb4_out_almost_empty), // Almost Empty?
+    .o_wb4_out_level        (o_wb4_out_level       )  // Entries in use
+  );
+  end // gearbox_fifo_gen
+  endgenerate
+
 endmodule // wb4_sync_fifo
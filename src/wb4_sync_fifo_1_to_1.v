@@ -16,12 +16,34 @@ Module Name  : wb4_sync_fifo_1_to_1
 Description  : Wishbone B4(pipelined) Sync FIFO
 
 Additional Comments:
-   
+   P_USE_BRAM=1 stores the words in a generic_sbram, the registered read adds
+   a clock so the standard read port acks two clocks after the strobe.
+   P_USE_BRAM=0 stores them in distributed (LUT) RAM read asynchronously, the
+   standard read port acks one clock after the strobe. Meant for shallow
+   FIFOs (8 to 32 entries) that should not use up a block RAM. The FWFT port
+   behaves the same with either memory.
+   P_BANK_DEPTH tiles the BRAM across wb4_banked_sbram banks of that depth,
+   the latency does not change.
+   P_BYPASS=1 (standard read port only) forwards a write straight into the
+   read data register when the FIFO is empty, no read is in flight and the
+   reader strobes on the same clock. The word is not stored, it is acked on
+   both ports one clock later, so under light load a word goes through in a
+   single clock. The read STALL then depends on the write strobe.
+   P_PEEK=1 adds a look-ahead port. A read returns the entry ADR places past
+   the head without popping it, acked one clock after the strobe, it stalls
+   while ADR >= level. A write skips ADR entries, the read pointer moves past
+   them in one clock, it stalls while ADR > level or the read port pops on
+   the same clock. The BRAM build reads a second memory written along with
+   the first one, the LUT build reads the same array a second time.
 */
 module wb4_sync_fifo_1_to_1 #(
   parameter integer P_DATA_MSB = 7,   // FIFO Width-1
-  parameter integer P_DEPTH    = 128, // FIFO $clog2(Depth)-1
-  parameter integer P_USE_BRAM = 1    // BRAM of LUT based
+  parameter integer P_DEPTH    = 128, // FIFO Depth, any value
+  parameter integer P_USE_BRAM = 1,   // BRAM of LUT based
+  parameter integer P_FWFT     = 0,   // 1=First-Word-Fall-Through (show-ahead) read port
+  parameter integer P_BANK_DEPTH = 0, // 0=One memory, else BRAM bank depth (power of 2)
+  parameter integer P_BYPASS   = 0,   // 1=Empty FIFO write to read bypass (standard read port)
+  parameter integer P_PEEK     = 0    // 1=Look-ahead read and skip port
 )(
   // Component's clocks and resets
   input i_clk, // clock
@@ -32,42 +54,143 @@ module wb4_sync_fifo_1_to_1 #(
   output                o_wb4_in_sack,   // Write Strobe
   input  [P_DATA_MSB:0] i_wb4_in_sdata,  // Write Data
   output                o_wb4_in_sstall, // Full?
+  // Write Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
   // Read Interface Signals
   input                 i_wb4_out_scyc,   // Read Strobe
   input                 i_wb4_out_sstb,   // Read Strobe
   output                o_wb4_out_sack,   // Write Strobe
   output [P_DATA_MSB:0] o_wb4_out_sdata,  // Read Data
-  output                o_wb4_out_sstall  // Empty?
+  output                o_wb4_out_sstall, // Empty?
+  // Read Side Fill Level
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level,         // Entries in use
+  // Peek Interface Signals, P_PEEK=1
+  input                      i_wb4_peek_scyc,  // Cycle
+  input                      i_wb4_peek_sstb,  // Strobe
+  input                      i_wb4_peek_swe,   // 0=Read head+ADR, 1=Skip ADR entries
+  input  [$clog2(P_DEPTH):0] i_wb4_peek_sadr,  // Entries past the head
+  output                     o_wb4_peek_sack,  // Acknowledge
+  output [P_DATA_MSB:0]      o_wb4_peek_sdata, // Entry at head+ADR
+  output                     o_wb4_peek_sstall // Not that many entries stored
 );
 
   ///////////////////////////////////////////////////////////////////////////////
   // Internal Parameter Declarations
   ///////////////////////////////////////////////////////////////////////////////
   localparam integer L_ADDR_MSB = $clog2(P_DEPTH)-1;
-  localparam integer L_PTR_PAD  = L_ADDR_MSB-1;
+  localparam integer L_BANK_ADDR_MSB = (P_BANK_DEPTH == 0) ? L_ADDR_MSB : $clog2(P_BANK_DEPTH)-1;
+  // The pointers carry one extra wrap bit so all P_DEPTH entries are usable.
+  localparam integer L_PTR_MSB  = L_ADDR_MSB+1;
+  localparam integer L_PTR_PAD  = L_PTR_MSB;
+  localparam integer L_POW2     = ((P_DEPTH & (P_DEPTH-1)) == 0) ? 1 : 0;
 
   ///////////////////////////////////////////////////////////////////////////////
   // Internal Signals Declarations
   ///////////////////////////////////////////////////////////////////////////////
   // Write Proc
-  reg [L_ADDR_MSB:0] r_write_ptr;
-  reg                r_full;
-  reg                r_write_ack;
+  reg [L_PTR_MSB:0] r_write_ptr;
+  reg               r_write_ack;
   // Read Proc
-  reg [L_ADDR_MSB:0] r_read_ptr;
-  reg                r_empty;
-  reg                r_read_ack;
-  reg [P_DATA_MSB:0] r_read_data;
+  reg  [L_PTR_MSB:0]  r_read_ptr;
+  reg                 r_empty;
+  reg                 r_read_req;
+  reg                 r_read_ack;
+  reg  [P_DATA_MSB:0] r_read_data;
   wire [P_DATA_MSB:0] w_read_data;
+  wire [L_PTR_MSB:0]  w_read_ptr_next;
+  wire [L_ADDR_MSB:0] w_read_addr;
+  wire                w_pop;
+  // Level Proc
+  reg [L_PTR_MSB:0] r_level;
+  reg               r_almost_full;
+  reg               r_almost_empty;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Functions   : Modulo Pointers
+  // Description : The pointers count 0 to 2*P_DEPTH-1, the top half is the
+  //               wrapped lap. With a power of 2 depth this is the natural
+  //               binary wrap and the functions fold back to plain adds.
+  ///////////////////////////////////////////////////////////////////////////////
+  function [L_PTR_MSB:0] ptr_inc;
+    input [L_PTR_MSB:0] ptr;
+    input               inc;
+    begin
+      if (L_POW2 == 1 || ptr != (2*P_DEPTH)-1) begin
+        ptr_inc = ptr + {{L_PTR_PAD{1'b0}}, {inc}};
+      end
+      else begin
+        ptr_inc = (inc == 1'b1) ? {(L_PTR_MSB+1){1'b0}} : ptr;
+      end
+    end
+  endfunction
+
+  // Entries between two pointers
+  function [L_PTR_MSB:0] ptr_diff;
+    input [L_PTR_MSB:0] ptr_a;
+    input [L_PTR_MSB:0] ptr_b;
+    begin
+      if (L_POW2 == 1 || ptr_a >= ptr_b) begin
+        ptr_diff = ptr_a - ptr_b;
+      end
+      else begin
+        ptr_diff = ptr_a + (2*P_DEPTH) - ptr_b;
+      end
+    end
+  endfunction
+
+  // Pointer moved cnt entries ahead, cnt <= P_DEPTH
+  function [L_PTR_MSB:0] ptr_add;
+    input [L_PTR_MSB:0] ptr;
+    input [L_PTR_MSB:0] cnt;
+    reg   [L_PTR_MSB+1:0] sum;
+    begin
+      sum = ptr + cnt;
+      if (L_POW2 == 1 || sum < (2*P_DEPTH)) begin
+        ptr_add = sum[L_PTR_MSB:0];
+      end
+      else begin
+        ptr_add = sum - (2*P_DEPTH);
+      end
+    end
+  endfunction
+
+  // Memory address of a pointer
+  function [L_ADDR_MSB:0] ptr2addr;
+    input [L_PTR_MSB:0] ptr;
+    begin
+      if (L_POW2 == 1 || ptr < P_DEPTH) begin
+        ptr2addr = ptr[L_ADDR_MSB:0];
+      end
+      else begin
+        ptr2addr = ptr - P_DEPTH;
+      end
+    end
+  endfunction
+
+  // Bypass, see std_read_gen
+  wire w_bypass;
+  // Peek, see peek_gen
+  wire                w_skip;
+  wire [L_PTR_MSB:0]  w_skip_ptr;
+  wire [L_ADDR_MSB:0] w_peek_addr;
+  wire [P_DATA_MSB:0] w_peek_data;
 
   //
   wire w_ce = !i_rst;
   // Write Controls Asynch Logic
-  wire w_full = $signed(r_write_ptr)+1 == $signed(r_read_ptr) ? 1'b1 : 1'b0;
+  wire w_full = (ptr_diff(r_write_ptr, r_read_ptr) == P_DEPTH) ? 1'b1 : 1'b0;
   wire w_we   = i_wb4_in_scyc & i_wb4_in_sstb;
+  // A write into a full FIFO is accepted when a read frees the slot this cycle.
+  // A bypassed write is not stored.
+  wire w_push = w_we & (~w_full | w_pop) & ~w_bypass;
+  wire [L_PTR_MSB:0]  w_write_ptr_next = ptr_inc(r_write_ptr, w_push);
+  wire [L_ADDR_MSB:0] w_write_addr     = ptr2addr(r_write_ptr);
   // Read Controls Asynch Logic
-  wire w_empty = $signed(r_read_ptr) == $signed(r_write_ptr) ? 1'b1 : 1'b0;
-  wire w_re    = i_wb4_out_scyc & i_wb4_out_sstb;
+  wire w_re = i_wb4_out_scyc & i_wb4_out_sstb;
 
   ///////////////////////////////////////////////////////////////////////////////
   //            ********      Architecture Declaration      ********           //
@@ -81,15 +204,13 @@ module wb4_sync_fifo_1_to_1 #(
   always @(posedge i_clk) begin : Write_Proc
     if (i_rst == 1'b1) begin
       r_write_ptr <= 'h0;
-      r_full      <= 1'b0;
     end
     else begin
-      r_write_ptr <= r_write_ptr + {{L_PTR_PAD{1'b0}}, {(w_we & !w_full)}}; //
-      r_full      <= w_full;
+      r_write_ptr <= w_write_ptr_next;
     end
   end // Write_Proc
-  // Memory read-address pointer (okay to use binary to address memory)
-  assign o_wb4_in_sstall = r_full;
+  // Stall only when full and nothing is being read out on this cycle.
+  assign o_wb4_in_sstall = w_full & ~w_pop;
 
   /////////////////////////////////////////////////////////////////////////////
   // Process     :  Write Pointer Process
@@ -100,103 +221,269 @@ module wb4_sync_fifo_1_to_1 #(
       r_write_ack <= 1'b0;
     end
     else begin
-      if(r_full == 1'b0) begin
-        // 
-        r_write_ack <= i_wb4_in_sstb;
-      end
-      else begin
-        r_write_ack <= 1'b0;
-      end
+      r_write_ack <= w_push | w_bypass;
     end
   end // write_ack_proc
   //
   assign o_wb4_in_sack = r_write_ack;
 
   /////////////////////////////////////////////////////////////////////////////
-  // Process     :  Read Pointer Process
-  // Description : .
+  // Process     :  Fill Level Process
+  // Description : Level and flags are registered from the next state pointers
+  //               so they are exact on every clock.
   /////////////////////////////////////////////////////////////////////////////
-  always @(posedge i_clk) begin: read_ptr_proc
+  wire [L_PTR_MSB:0] w_level_next = ptr_diff(w_write_ptr_next, w_read_ptr_next);
+
+  always @(posedge i_clk) begin : level_proc
     if (i_rst == 1'b1) begin
-      r_read_ptr <= 'h0;
-      r_empty    <= 1'b1;
-      r_read_data <= 0;
+      r_level        <= 'h0;
+      r_almost_full  <= 1'b0;
+      r_almost_empty <= 1'b1;
     end
     else begin
-      r_read_ptr  <= r_read_ptr + {{L_PTR_PAD{1'b0}}, {(w_re & ~w_empty)}}; //
-      r_empty     <= w_empty;
-      r_read_data <= w_read_data;
+      r_level        <= w_level_next;
+      r_almost_full  <= (w_level_next >= i_wb4_in_afull_thresh) ? 1'b1 : 1'b0;
+      r_almost_empty <= (w_level_next <= i_wb4_out_aempty_thresh) ? 1'b1 : 1'b0;
     end
-  end // read_ptr_proc
+  end // level_proc
+  //
+  assign o_wb4_in_level         = r_level;
+  assign o_wb4_in_almost_full   = r_almost_full;
+  assign o_wb4_out_level        = r_level;
+  assign o_wb4_out_almost_empty = r_almost_empty;
 
-  /////////////////////////////////////////////////////////////////////////////
-  // Process     :  Read Pointer Process
-  // Description : .
-  /////////////////////////////////////////////////////////////////////////////
-  always @(posedge i_clk) begin: read_ack_proc
-    if (i_rst == 1'b1 || i_wb4_out_scyc == 1'b0) begin
-      r_read_ack <= 1'b0;
-    end
-    else begin
-      if(r_empty == 1'b0) begin
-        // 
-        r_read_ack <= i_wb4_out_sstb;
-      end
-      else begin
-        r_read_ack <= 1'b0;
-      end
-    end
-  end // read_ack_proc
-  // 
-  assign o_wb4_out_sack = r_read_ack;
-  // Memory read-address pointer (okay to use binary to address memory)
-  assign o_wb4_out_sstall = r_empty;
-  assign o_wb4_out_sdata  = r_read_data;
+  generate
+    if (P_FWFT == 0) begin: std_read_gen
+      // A word is readable once it has been written to memory, the BRAM output
+      // register and r_read_data then deliver it two clocks after the strobe.
+      // The LUT read is asynchronous, r_read_data captures it on the pop edge.
+      assign w_pop           = w_re & ~r_empty;
+      assign w_read_ptr_next = (w_skip == 1'b1) ? w_skip_ptr : ptr_inc(r_read_ptr, w_pop);
+      // The write can go straight to r_read_data while nothing is stored and
+      // no read is on its way out of the memory, the order is kept.
+      wire w_bypass_rdy = (P_BYPASS == 1) ? r_empty & ~(r_read_req & (P_USE_BRAM == 1)) & w_we : 1'b0;
+      assign w_bypass    = w_bypass_rdy & w_re;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  Read Pointer Process
+      // Description : Empty is registered from the next state pointers so it
+      //               does not lag the pointers.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin: read_ptr_proc
+        if (i_rst == 1'b1) begin
+          r_read_ptr  <= 'h0;
+          r_empty     <= 1'b1;
+          r_read_data <= 0;
+        end
+        else begin
+          r_read_ptr  <= w_read_ptr_next;
+          r_empty     <= (w_read_ptr_next == w_write_ptr_next) ? 1'b1 : 1'b0;
+          r_read_data <= (w_bypass == 1'b1) ? i_wb4_in_sdata : w_read_data;
+        end
+      end // read_ptr_proc
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  Read Ack Process
+      // Description : Follows the memory and r_read_data latency.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin: read_ack_proc
+        if (i_rst == 1'b1 || i_wb4_out_scyc == 1'b0) begin
+          r_read_req <= 1'b0;
+          r_read_ack <= 1'b0;
+        end
+        else begin
+          r_read_req <= w_pop;
+          r_read_ack <= ((P_USE_BRAM == 1) ? r_read_req : w_pop) | w_bypass;
+        end
+      end // read_ack_proc
+      // 
+      assign o_wb4_out_sack = r_read_ack;
+      // Memory read-address pointer (okay to use binary to address memory)
+      assign w_read_addr      = ptr2addr(r_read_ptr);
+      assign o_wb4_out_sstall = r_empty & ~w_bypass_rdy;
+      assign o_wb4_out_sdata  = r_read_data;
+    end // std_read_gen
+  endgenerate
+
+  generate
+    if (P_FWFT == 1) begin: fwft_read_gen
+      // The BRAM output register is used as the prefetched head register. The
+      // read address looks one entry ahead on a pop so the next word is loaded
+      // on the same edge, and holds otherwise so the head word stays on the bus.
+      reg r_head_valid; // Head register holds a valid word
+
+      assign w_pop           = w_re & r_head_valid;
+      assign w_read_ptr_next = (w_skip == 1'b1) ? w_skip_ptr : ptr_inc(r_read_ptr, w_pop);
+      assign w_bypass        = 1'b0;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  FWFT Read Pointer Process
+      // Description : The head is valid once the word at the new read pointer
+      //               was committed to memory before this edge.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin: fwft_read_ptr_proc
+        if (i_rst == 1'b1) begin
+          r_read_ptr   <= 'h0;
+          r_head_valid <= 1'b0;
+        end
+        else begin
+          r_read_ptr   <= w_read_ptr_next;
+          r_head_valid <= (w_read_ptr_next != r_write_ptr) ? 1'b1 : 1'b0;
+        end
+      end // fwft_read_ptr_proc
+      // Zero wait state ack, the head word is already on the data bus.
+      assign o_wb4_out_sack = w_pop;
+      // Memory read-address pointer (okay to use binary to address memory)
+      assign w_read_addr      = ptr2addr(w_read_ptr_next);
+      assign o_wb4_out_sstall = ~r_head_valid;
+      assign o_wb4_out_sdata  = w_read_data;
+    end // fwft_read_gen
+  endgenerate
+
+  generate
+    if (P_PEEK == 1) begin: peek_gen
+      // Entries are counted from the head before this clock's pop or skip.
+      reg  r_peek_ack;
+      wire w_peek_acc = i_wb4_peek_scyc & i_wb4_peek_sstb & ~o_wb4_peek_sstall;
+      wire w_peek_rdy = (i_wb4_peek_sadr < r_level) ? 1'b1 : 1'b0;
+      wire w_skip_rdy = (i_wb4_peek_sadr <= r_level) ? ~w_pop : 1'b0;
+
+      assign w_skip      = w_peek_acc & i_wb4_peek_swe;
+      assign w_skip_ptr  = ptr_add(r_read_ptr, i_wb4_peek_sadr);
+      assign w_peek_addr = ptr2addr(w_skip_ptr);
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  Peek Ack Process
+      // Description : The peek memory output is registered on the strobe edge.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin: peek_ack_proc
+        if (i_rst == 1'b1 || i_wb4_peek_scyc == 1'b0) begin
+          r_peek_ack <= 1'b0;
+        end
+        else begin
+          r_peek_ack <= w_peek_acc;
+        end
+      end // peek_ack_proc
+      //
+      assign o_wb4_peek_sack   = r_peek_ack;
+      assign o_wb4_peek_sdata  = w_peek_data;
+      assign o_wb4_peek_sstall = (i_wb4_peek_swe == 1'b1) ? ~w_skip_rdy : ~w_peek_rdy;
+    end // peek_gen
+    else begin: no_peek_gen
+      assign w_skip            = 1'b0;
+      assign w_skip_ptr        = r_read_ptr;
+      assign w_peek_addr       = {(L_ADDR_MSB+1){1'b0}};
+      assign w_peek_data       = {(P_DATA_MSB+1){1'b0}};
+      assign o_wb4_peek_sack   = 1'b0;
+      assign o_wb4_peek_sdata  = {(P_DATA_MSB+1){1'b0}};
+      assign o_wb4_peek_sstall = 1'b1;
+    end // no_peek_gen
+  endgenerate
 
   generate
     if (P_USE_BRAM == 1) begin: bram_mem_gen
       ///////////////////////////////////////////////////////////////////////////////
       // Instance    : Single Port BRAM
-      // Description : Inferrable Single Port Block RAM.
+      // Description : Inferrable Single Port Block RAM, banked by P_BANK_DEPTH.
       ///////////////////////////////////////////////////////////////////////////////
-      generic_sbram #(
+      wb4_banked_sbram #(
         // Compile time configurable parameters
         .P_SBRAM_DATA_MSB (P_DATA_MSB),
         .P_SBRAM_ADDR_MSB (L_ADDR_MSB),
         .P_SBRAM_MASK_MSB (0),
+        .P_SBRAM_DEPTH    (P_DEPTH),
+        .P_BANK_ADDR_MSB  (L_BANK_ADDR_MSB),
         .P_SBRAM_HAS_FILE (0),
         .P_SBRAM_INIT_FILE(0)
       ) fifo_mem_inst (
         .i_ce   (w_ce           ),
         .i_wclk (i_clk          ),
         .i_rclk (i_clk          ),
-        .i_waddr(r_write_ptr    ),
-        .i_raddr(r_read_ptr     ),
-        .i_we   (w_we           ),
+        .i_waddr(w_write_addr   ),
+        .i_raddr(w_read_addr    ),
+        .i_we   (w_push         ),
         .i_mask (0              ), // 0=writes, 1=masks
         .i_wdata(i_wb4_in_sdata ),
         .o_rdata(w_read_data    )
       );
+
+      if (P_PEEK == 1) begin: bram_peek_gen
+        ///////////////////////////////////////////////////////////////////////////////
+        // Instance    : Peek BRAM
+        // Description : Written along with fifo_mem_inst, read at head+ADR.
+        ///////////////////////////////////////////////////////////////////////////////
+        wb4_banked_sbram #(
+          // Compile time configurable parameters
+          .P_SBRAM_DATA_MSB (P_DATA_MSB),
+          .P_SBRAM_ADDR_MSB (L_ADDR_MSB),
+          .P_SBRAM_MASK_MSB (0),
+          .P_SBRAM_DEPTH    (P_DEPTH),
+          .P_BANK_ADDR_MSB  (L_BANK_ADDR_MSB),
+          .P_SBRAM_HAS_FILE (0),
+          .P_SBRAM_INIT_FILE(0)
+        ) peek_mem_inst (
+          .i_ce   (w_ce           ),
+          .i_wclk (i_clk          ),
+          .i_rclk (i_clk          ),
+          .i_waddr(w_write_addr   ),
+          .i_raddr(w_peek_addr    ),
+          .i_we   (w_push         ),
+          .i_mask (0              ), // 0=writes, 1=masks
+          .i_wdata(i_wb4_in_sdata ),
+          .o_rdata(w_peek_data    )
+        );
+      end // bram_peek_gen
     end // bram_mem_gen
   endgenerate
 
-  generate // TBD --- IN PROGRESS
-    if (P_USE_BRAM == 0) begin: Gen_LUT_MEM
+  generate
+    if (P_USE_BRAM == 0) begin: lut_mem_gen
       // Mem Block
       reg [P_DATA_MSB:0] mem [0:P_DEPTH-1] /*verilator public*/;
 
       /////////////////////////////////////////////////////////////////////////////
-      // Process     : Mem Process
+      // Process     : LUT Write Process
       // Description : .
       /////////////////////////////////////////////////////////////////////////////
-      always @(posedge i_clk) begin : Lut_Write_Proc
-        if (i_wb4_in_scyc == 1'b1 && w_we == 1'b1) begin
-          mem[r_write_ptr] <= i_wb4_in_sdata;
+      always @(posedge i_clk) begin : lut_write_proc
+        if (w_push == 1'b1) begin
+          mem[w_write_addr] <= i_wb4_in_sdata;
         end
-      end // Lut_Write_Proc
-      // Read
-      assign o_wb4_out_sdata = mem[r_read_ptr];
-    end // Gen_LUT_MEM
+      end // lut_write_proc
+
+      if (P_FWFT == 1) begin: lut_head_gen
+        reg [P_DATA_MSB:0] r_lut_data;
+
+        /////////////////////////////////////////////////////////////////////////////
+        // Process     : LUT Head Process
+        // Description : The FWFT port uses the memory output as its head
+        //               register, the look-ahead read is registered like the BRAM.
+        /////////////////////////////////////////////////////////////////////////////
+        always @(posedge i_clk) begin : lut_head_proc
+          r_lut_data <= mem[w_read_addr];
+        end // lut_head_proc
+        //
+        assign w_read_data = r_lut_data;
+      end // lut_head_gen
+      else begin: lut_async_gen
+        // Asynchronous read
+        assign w_read_data = mem[w_read_addr];
+      end // lut_async_gen
+
+      if (P_PEEK == 1) begin: lut_peek_gen
+        reg [P_DATA_MSB:0] r_lut_peek;
+
+        /////////////////////////////////////////////////////////////////////////////
+        // Process     : LUT Peek Process
+        // Description : Second read of the array, registered like the BRAM.
+        /////////////////////////////////////////////////////////////////////////////
+        always @(posedge i_clk) begin : lut_peek_proc
+          r_lut_peek <= mem[w_peek_addr];
+        end // lut_peek_proc
+        //
+        assign w_peek_data = r_lut_peek;
+      end // lut_peek_gen
+    end // lut_mem_gen
   endgenerate
 
 endmodule // wb4_sync_fifo_1_to_1
@@ -0,0 +1,303 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_sync_fifo_1_to_N.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_sync_fifo_1_to_N
+Description  : Wishbone B4(pipelined) Sync FIFO One-To-Many
+
+Additional Comments:
+   Stores the wide input words and hands out the narrow sub-words, least
+   significant first, one per read clock. The BRAM output register holds the
+   head word (look-ahead read address) and a sub-word counter walks it, the
+   next word is fetched on the edge the last sub-word is popped so there are
+   no bubbles between words.
+*/
+module wb4_sync_fifo_1_to_N #(
+  parameter integer P_DATA_I_MSB = 31, // FIFO Width-1
+  parameter integer P_DATA_O_MSB = 7,  // FIFO Width-1
+  parameter integer P_DEPTH      = 128, // FIFO Depth in input words
+  parameter integer P_USE_BRAM   = 1,   // BRAM of LUT based
+  parameter integer P_BANK_DEPTH = 0    // 0=One memory, else BRAM bank depth (power of 2)
+)(
+  // Component's clocks and resets
+  input i_clk, // clock
+  input i_rst, // reset
+  // Write Interface  Signals
+  input                   i_wb4_in_scyc,   // Enable
+  input                   i_wb4_in_sstb,   // Write Strobe
+  output                  o_wb4_in_sack,   // Write Strobe
+  input  [P_DATA_I_MSB:0] i_wb4_in_sdata,  // Write Data
+  output                  o_wb4_in_sstall, // Full?
+  // Write Side Fill Level (in input words)
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
+  // Read Interface Signals
+  input                   i_wb4_out_scyc,   // Read Strobe
+  input                   i_wb4_out_sstb,   // Read Strobe
+  output                  o_wb4_out_sack,   // Write Strobe
+  output [P_DATA_O_MSB:0] o_wb4_out_sdata,  // Read Data
+  output                  o_wb4_out_sstall, // Empty?
+  // Read Side Fill Level (in input words)
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level          // Entries in use
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_ADDR_MSB = $clog2(P_DEPTH)-1;
+  localparam integer L_BANK_ADDR_MSB = (P_BANK_DEPTH == 0) ? L_ADDR_MSB : $clog2(P_BANK_DEPTH)-1;
+  // The pointers carry one extra wrap bit so all P_DEPTH entries are usable.
+  localparam integer L_PTR_MSB  = L_ADDR_MSB+1;
+  localparam integer L_PTR_PAD  = L_PTR_MSB;
+  localparam integer L_POW2     = ((P_DEPTH & (P_DEPTH-1)) == 0) ? 1 : 0;
+  //
+  localparam integer L_DATA_O_REPLI = (P_DATA_I_MSB+1)/(P_DATA_O_MSB+1);
+  localparam integer L_DATA_O_WIDTH = P_DATA_O_MSB+1;
+  localparam integer L_UNIT_MSB     = (L_DATA_O_REPLI > 1) ? $clog2(L_DATA_O_REPLI)-1 : 0;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Write Proc
+  reg [L_PTR_MSB:0] r_write_ptr;
+  reg               r_write_ack;
+  // Read Proc
+  reg  [L_PTR_MSB:0]    r_read_ptr;
+  reg                   r_head_valid; // BRAM output holds the head word
+  reg  [L_UNIT_MSB:0]   r_unit_cnt;   // Sub-words already popped from the head word
+  reg                   r_read_ack;
+  reg  [P_DATA_O_MSB:0] r_read_data;
+  wire [P_DATA_I_MSB:0] w_read_data;
+  wire [L_ADDR_MSB:0]   w_read_addr;
+  // Level Proc
+  reg [L_PTR_MSB:0] r_level;
+  reg               r_almost_full;
+  reg               r_almost_empty;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Functions   : Modulo Pointers
+  // Description : The pointers count 0 to 2*P_DEPTH-1, the top half is the
+  //               wrapped lap. With a power of 2 depth this is the natural
+  //               binary wrap and the functions fold back to plain adds.
+  ///////////////////////////////////////////////////////////////////////////////
+  function [L_PTR_MSB:0] ptr_inc;
+    input [L_PTR_MSB:0] ptr;
+    input               inc;
+    begin
+      if (L_POW2 == 1 || ptr != (2*P_DEPTH)-1) begin
+        ptr_inc = ptr + {{L_PTR_PAD{1'b0}}, {inc}};
+      end
+      else begin
+        ptr_inc = (inc == 1'b1) ? {(L_PTR_MSB+1){1'b0}} : ptr;
+      end
+    end
+  endfunction
+
+  // Entries between two pointers
+  function [L_PTR_MSB:0] ptr_diff;
+    input [L_PTR_MSB:0] ptr_a;
+    input [L_PTR_MSB:0] ptr_b;
+    begin
+      if (L_POW2 == 1 || ptr_a >= ptr_b) begin
+        ptr_diff = ptr_a - ptr_b;
+      end
+      else begin
+        ptr_diff = ptr_a + (2*P_DEPTH) - ptr_b;
+      end
+    end
+  endfunction
+
+  // Memory address of a pointer
+  function [L_ADDR_MSB:0] ptr2addr;
+    input [L_PTR_MSB:0] ptr;
+    begin
+      if (L_POW2 == 1 || ptr < P_DEPTH) begin
+        ptr2addr = ptr[L_ADDR_MSB:0];
+      end
+      else begin
+        ptr2addr = ptr - P_DEPTH;
+      end
+    end
+  endfunction
+
+  //
+  wire w_ce = !i_rst;
+  // Read Controls Asynch Logic
+  wire w_re       = i_wb4_out_scyc & i_wb4_out_sstb;
+  wire w_pop      = w_re & r_head_valid;
+  wire w_word_pop = w_pop && (r_unit_cnt == L_DATA_O_REPLI-1);
+  wire [L_PTR_MSB:0] w_read_ptr_next = ptr_inc(r_read_ptr, w_word_pop);
+  // Write Controls Asynch Logic
+  wire w_full = (ptr_diff(r_write_ptr, r_read_ptr) == P_DEPTH) ? 1'b1 : 1'b0;
+  wire w_we   = i_wb4_in_scyc & i_wb4_in_sstb;
+  // A write into a full FIFO is accepted when the head word is released this cycle.
+  wire w_push = w_we & (~w_full | w_word_pop);
+  wire [L_PTR_MSB:0]  w_write_ptr_next = ptr_inc(r_write_ptr, w_push);
+  wire [L_ADDR_MSB:0] w_write_addr     = ptr2addr(r_write_ptr);
+  wire [L_PTR_MSB:0]  w_level_next     = ptr_diff(w_write_ptr_next, w_read_ptr_next);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Pointer Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : Write_Proc
+    if (i_rst == 1'b1) begin
+      r_write_ptr <= 'h0;
+    end
+    else begin
+      r_write_ptr <= w_write_ptr_next;
+    end
+  end // Write_Proc
+  // Stall only when full and the head word is not released on this cycle.
+  assign o_wb4_in_sstall = w_full & ~w_word_pop;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Ack Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : write_ack_proc
+    if (i_rst == 1'b1 || i_wb4_in_scyc == 1'b0) begin
+      r_write_ack <= 1'b0;
+    end
+    else begin
+      r_write_ack <= w_push;
+    end
+  end // write_ack_proc
+  //
+  assign o_wb4_in_sack = r_write_ack;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read Pointer Process
+  // Description : The head is valid once the word at the new read pointer
+  //               was committed to memory before this edge. The read pointer
+  //               only moves when the last sub-word of the head is popped.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : read_ptr_proc
+    if (i_rst == 1'b1) begin
+      r_read_ptr   <= 'h0;
+      r_head_valid <= 1'b0;
+      r_unit_cnt   <= 'h0;
+    end
+    else begin
+      r_read_ptr   <= w_read_ptr_next;
+      r_head_valid <= (w_read_ptr_next != r_write_ptr) ? 1'b1 : 1'b0;
+      if (w_pop == 1'b1) begin
+        r_unit_cnt <= (w_word_pop == 1'b1) ? 'h0 : r_unit_cnt + 1;
+      end
+    end
+  end // read_ptr_proc
+  // Memory read-address pointer (okay to use binary to address memory)
+  assign w_read_addr      = ptr2addr(w_read_ptr_next);
+  assign o_wb4_out_sstall = ~r_head_valid;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read Data Process
+  // Description : Registers the selected sub-word, ack on the following clock.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : read_data_proc
+    if (i_rst == 1'b1 || i_wb4_out_scyc == 1'b0) begin
+      r_read_ack  <= 1'b0;
+      r_read_data <= 0;
+    end
+    else begin
+      r_read_ack <= w_pop;
+      if (w_pop == 1'b1) begin
+        r_read_data <= w_read_data[r_unit_cnt*L_DATA_O_WIDTH +: L_DATA_O_WIDTH];
+      end
+    end
+  end // read_data_proc
+  //
+  assign o_wb4_out_sack  = r_read_ack;
+  assign o_wb4_out_sdata = r_read_data;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Fill Level Process
+  // Description : Level and flags are registered from the next state pointers
+  //               so they are exact on every clock.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : level_proc
+    if (i_rst == 1'b1) begin
+      r_level        <= 'h0;
+      r_almost_full  <= 1'b0;
+      r_almost_empty <= 1'b1;
+    end
+    else begin
+      r_level        <= w_level_next;
+      r_almost_full  <= (w_level_next >= i_wb4_in_afull_thresh) ? 1'b1 : 1'b0;
+      r_almost_empty <= (w_level_next <= i_wb4_out_aempty_thresh) ? 1'b1 : 1'b0;
+    end
+  end // level_proc
+  //
+  assign o_wb4_in_level         = r_level;
+  assign o_wb4_in_almost_full   = r_almost_full;
+  assign o_wb4_out_level        = r_level;
+  assign o_wb4_out_almost_empty = r_almost_empty;
+
+  generate
+    if (P_USE_BRAM == 1) begin: bram_mem_gen
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Single Port BRAM
+      // Description : Inferrable Single Port Block RAM, banked by P_BANK_DEPTH.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_banked_sbram #(
+        // Compile time configurable parameters
+        .P_SBRAM_DATA_MSB (P_DATA_I_MSB),
+        .P_SBRAM_ADDR_MSB (L_ADDR_MSB),
+        .P_SBRAM_MASK_MSB (0),
+        .P_SBRAM_DEPTH    (P_DEPTH),
+        .P_BANK_ADDR_MSB  (L_BANK_ADDR_MSB),
+        .P_SBRAM_HAS_FILE (0),
+        .P_SBRAM_INIT_FILE(0)
+      ) fifo_mem_inst (
+        .i_ce   (w_ce           ),
+        .i_wclk (i_clk          ),
+        .i_rclk (i_clk          ),
+        .i_waddr(w_write_addr   ),
+        .i_raddr(w_read_addr    ),
+        .i_we   (w_push         ),
+        .i_mask (0              ), // 0=writes, 1=masks
+        .i_wdata(i_wb4_in_sdata ),
+        .o_rdata(w_read_data    )
+      );
+    end // bram_mem_gen
+  endgenerate
+
+  generate
+    if (P_USE_BRAM == 0) begin: lut_mem_gen
+      // Mem Block
+      reg [P_DATA_I_MSB:0] mem [0:P_DEPTH-1] /*verilator public*/;
+      reg [P_DATA_I_MSB:0] r_lut_data;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     : Mem Process
+      // Description : Registered read so the LUTs behave like the BRAM.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin : lut_mem_proc
+        if (w_push == 1'b1) begin
+          mem[w_write_addr] <= i_wb4_in_sdata;
+        end
+        r_lut_data <= mem[w_read_addr];
+      end // lut_mem_proc
+      //
+      assign w_read_data = r_lut_data;
+    end // lut_mem_gen
+  endgenerate
+
+endmodule // wb4_sync_fifo_1_to_N
@@ -16,14 +16,29 @@ Module Name  : wb4_sync_fifo_N_to_1
 Description  : Wishbone B4(pipelined) Sync FIFO Many-To-One
 
 Additional Comments:
-   
+   P_USE_BRAM=0 stores the words in distributed (LUT) RAM instead of a
+   generic_sbram. The lane mask is applied the same way and the read is
+   registered like the BRAM's, so the latency is the same with either memory.
+   P_SKID_BUFFER=1 puts a wb4_wr_skid_buffer in front of the write port and a
+   wb4_rd_skid_buffer behind the read port so STALL and DAT come from flops
+   on both sides instead of the full/empty logic. Bursts still run at one
+   beat per clock, the read buffer prefetches up to 4 words out of the FIFO.
+   The input words are packed into the word at the write pointer, lane by lane
+   from the LSB. The pointer moves on with the last lane, so after the first
+   word there is one output word every L_DATA_I_REPLI input beats with no
+   dead clocks in between, reads only wait on the fill level.
+   i_wb4_in_flush (one clock) closes a partial word with the beats taken so
+   far, including one taken on the same clock. The lanes not written hold
+   stale data. A flush with no partial word does nothing.
 */
 module wb4_sync_fifo_N_to_1 #(
   parameter integer P_DATA_I_MSB = 7,            // FIFO Width-1
   parameter integer P_DATA_O_MSB = P_DATA_I_MSB, // FIFO Width-1
-  parameter integer P_DEPTH      = 128,          // FIFO $clog2(Depth)-1
+  parameter integer P_DEPTH      = 128,          // FIFO Depth, any value
   parameter integer P_USE_BRAM   = 1,            // BRAM of LUT based
-  parameter integer P_MASK_MSB   = P_DATA_O_MSB  // P_DATA_O_MSB=bit, (P_DATA_O_MSB+1)/4=nibble...
+  parameter integer P_MASK_MSB   = P_DATA_O_MSB, // P_DATA_O_MSB=bit, (P_DATA_O_MSB+1)/4=nibble...
+  parameter integer P_SKID_BUFFER = 0,           // 1=Registered STALL/DAT on both ports
+  parameter integer P_BANK_DEPTH  = 0            // 0=One memory, else BRAM bank depth (power of 2)
 )(
   // Component's clocks and resets
   input i_clk, // clock
@@ -34,22 +49,36 @@ module wb4_sync_fifo_N_to_1 #(
   output                  o_wb4_in_sack,   // Write Strobe
   input  [P_DATA_I_MSB:0] i_wb4_in_sdata,  // Write Data
   output                  o_wb4_in_sstall, // Full?
+  input                   i_wb4_in_flush,  // Close the partial output word
+  // Write Side Fill Level (in output words)
+  input  [$clog2(P_DEPTH):0] i_wb4_in_afull_thresh,  // Almost Full when level >= thresh
+  output                     o_wb4_in_almost_full,   // Almost Full?
+  output [$clog2(P_DEPTH):0] o_wb4_in_level,         // Entries in use
   // Read Interface Signals
   input                   i_wb4_out_scyc,   // Read Strobe
   input                   i_wb4_out_sstb,   // Read Strobe
   output                  o_wb4_out_sack,   // Write Strobe
   output [P_DATA_O_MSB:0] o_wb4_out_sdata,  // Read Data
-  output                  o_wb4_out_sstall  // Empty?
+  output                  o_wb4_out_sstall, // Empty?
+  // Read Side Fill Level (in output words)
+  input  [$clog2(P_DEPTH):0] i_wb4_out_aempty_thresh, // Almost Empty when level <= thresh
+  output                     o_wb4_out_almost_empty,  // Almost Empty?
+  output [$clog2(P_DEPTH):0] o_wb4_out_level          // Entries in use
 );
 
   ///////////////////////////////////////////////////////////////////////////////
   // Internal Parameter Declarations
   ///////////////////////////////////////////////////////////////////////////////
   // General
-  localparam integer L_ADDR_MSB = $clog2(P_DEPTH)-1;
+  localparam integer L_ADDR_MSB  = $clog2(P_DEPTH)-1;
+  localparam integer L_BANK_ADDR_MSB = (P_BANK_DEPTH == 0) ? L_ADDR_MSB : $clog2(P_BANK_DEPTH)-1;
+  localparam integer L_LEVEL_MSB = L_ADDR_MSB+1;
+  localparam integer L_POW2      = ((P_DEPTH & (P_DEPTH-1)) == 0) ? 1 : 0;
   //
   localparam integer L_DATA_I_REPLI = (P_DATA_O_MSB+1)/(P_DATA_I_MSB+1);
+  localparam integer L_UNIT_CNT_MSB = (L_DATA_I_REPLI > 1) ? $clog2(L_DATA_I_REPLI)-1 : 0;
   // Mask
+  localparam integer        L_MASK_UNIT       = (P_DATA_O_MSB+1)/(P_MASK_MSB+1); // Bits per mask bit
   localparam integer        L_MASK_SHIFT_UNIT = (P_MASK_MSB+1)/(L_DATA_I_REPLI);
   localparam integer        L_MASK_PAD        = (P_MASK_MSB+1)-L_MASK_SHIFT_UNIT;
   localparam [P_MASK_MSB:0] L_MASK_INITIAL    = {{L_MASK_PAD{1'b1}}, {L_MASK_SHIFT_UNIT{1'b0}}};
@@ -59,124 +88,264 @@ module wb4_sync_fifo_N_to_1 #(
   ///////////////////////////////////////////////////////////////////////////////
   // Write Proc
   reg [L_ADDR_MSB:0] r_write_ptr;
-  reg                r_full;
-  reg [P_MASK_MSB:0] r_mask;
   reg                r_write_ack;
   // Read Proc
   reg [L_ADDR_MSB:0] r_read_ptr;
-  reg                r_empty_d;
-  reg                r_empty;
-  reg                r_warmedup;
   reg                r_read_ack;
+  // Level Proc
+  reg [L_LEVEL_MSB:0]    r_level;
+  reg [L_UNIT_CNT_MSB:0] r_unit_cnt; // Input words into the current output word
+  reg                    r_almost_full;
+  reg                    r_almost_empty;
+  // FIFO write port, straight from the bus or out of the skid buffer
+  wire                  w_wr_cyc;
+  wire                  w_wr_stb;
+  wire [P_DATA_I_MSB:0] w_wr_data;
+  // FIFO read port, straight from the bus or out of the skid buffer
+  wire       w_rd_cyc;
+  wire       w_rd_stb;
   // Data Input Wire
-  wire [P_MASK_MSB:0] w_in_data = {L_DATA_I_REPLI{i_wb4_in_sdata}};
-  // Write Controls Asynch Logic
-  wire w_we         = i_wb4_in_sstb & ~r_full;
-  wire w_wr_hazzard = ($signed(r_write_ptr) == $signed(r_read_ptr)-1) ? 1'b1 : 1'b0;
-  wire w_full       = w_wr_hazzard & i_wb4_in_sstb;
-  // Read Controls Asynch Logic
-  wire w_rd_hazzard = ($signed(r_read_ptr) == $signed(r_write_ptr)-1) ? 1'b1 : 1'b0;
-  wire w_empty      = w_rd_hazzard & i_wb4_out_sstb;
+  wire [P_MASK_MSB:0] w_in_data = {L_DATA_I_REPLI{w_wr_data}};
+  // Lanes of the input word in the output word, 0=writes, 1=masks
+  wire [P_MASK_MSB:0] w_mask = ~((~L_MASK_INITIAL) << (r_unit_cnt*L_MASK_SHIFT_UNIT));
+  // Memory Read Data
+  wire [P_DATA_O_MSB:0] w_read_data;
 
   ///////////////////////////////////////////////////////////////////////////////
-  //            ********      Architecture Declaration      ********           //
+  // Function    : Modulo Address Increment
+  // Description : Wraps at P_DEPTH, the natural binary wrap with a power of 2
+  //               depth.
   ///////////////////////////////////////////////////////////////////////////////
+  function [L_ADDR_MSB:0] addr_inc;
+    input [L_ADDR_MSB:0] addr;
+    input                inc;
+    begin
+      if (L_POW2 == 1 || addr != P_DEPTH-1) begin
+        addr_inc = addr + {{L_ADDR_MSB{1'b0}}, {inc}};
+      end
+      else begin
+        addr_inc = (inc == 1'b1) ? {(L_ADDR_MSB+1){1'b0}} : addr;
+      end
+    end
+  endfunction
+
+  //
+  wire w_ce = !i_rst;
+  // Write Controls Asynch Logic, full once every slot holds a whole word
+  wire w_full    = (r_level == P_DEPTH) ? 1'b1 : 1'b0;
+  wire w_we      = w_wr_cyc & w_wr_stb & ~w_full;
+  wire w_word_we = w_we && (r_unit_cnt == L_DATA_I_REPLI-1);
+  // A flush closes the partial word, with the beat taken on this clock if any
+  wire w_flush   = i_wb4_in_flush & (w_we | (r_unit_cnt != 0));
+  wire w_lvl_inc = w_word_we | w_flush;
+  // Read Controls Asynch Logic
+  wire w_empty   = (r_level == 0) ? 1'b1 : 1'b0;
+  wire w_lvl_dec = w_rd_cyc & w_rd_stb & ~w_empty;
+  // Level Controls Asynch Logic
+  wire [L_LEVEL_MSB:0] w_level_next = r_level + {{L_LEVEL_MSB{1'b0}}, w_lvl_inc} - {{L_LEVEL_MSB{1'b0}}, w_lvl_dec};
 
   ///////////////////////////////////////////////////////////////////////////////
-  // Instance    : Single Port BRAM
-  // Description : Inferrable Single Port Block RAM.
+  //            ********      Architecture Declaration      ********           //
   ///////////////////////////////////////////////////////////////////////////////
-  generic_sbram #(
-    // Compile time configurable parameters
-    .P_SBRAM_DATA_MSB(P_DATA_O_MSB),
-    .P_SBRAM_ADDR_MSB(L_ADDR_MSB),
-    .P_SBRAM_MASK_MSB(P_MASK_MSB),
-    .P_SBRAM_HAS_FILE(0),
-    .P_SBRAM_INIT_FILE(0)
-  ) fifo_mem_block_i (
-    .i_ce(i_wb4_in_scyc),
-    .i_wclk(i_clk),
-    .i_rclk(i_clk),
-    .i_waddr(r_write_ptr),
-    .i_raddr(r_read_ptr),
-    .i_we(w_we),
-    .i_mask(r_mask), // 0=writes, 1=masks
-    .i_wdata(w_in_data),
-    .o_rdata(o_wb4_out_sdata)
-  );
+
+  generate
+    if (P_USE_BRAM == 1) begin: bram_mem_gen
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Single Port BRAM
+      // Description : Inferrable Single Port Block RAM, banked by P_BANK_DEPTH.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_banked_sbram #(
+        // Compile time configurable parameters
+        .P_SBRAM_DATA_MSB(P_DATA_O_MSB),
+        .P_SBRAM_ADDR_MSB(L_ADDR_MSB),
+        .P_SBRAM_MASK_MSB(P_MASK_MSB),
+        .P_SBRAM_DEPTH(P_DEPTH),
+        .P_BANK_ADDR_MSB(L_BANK_ADDR_MSB),
+        .P_SBRAM_HAS_FILE(0),
+        .P_SBRAM_INIT_FILE(0)
+      ) fifo_mem_block_i (
+        .i_ce(w_ce),
+        .i_wclk(i_clk),
+        .i_rclk(i_clk),
+        .i_waddr(r_write_ptr),
+        .i_raddr(r_read_ptr),
+        .i_we(w_we),
+        .i_mask(w_mask), // 0=writes, 1=masks
+        .i_wdata(w_in_data),
+        .o_rdata(w_read_data)
+      );
+    end // bram_mem_gen
+    else begin: lut_mem_gen
+      // Mem Block
+      reg [P_DATA_O_MSB:0] mem [0:P_DEPTH-1] /*verilator public*/;
+      reg  [P_DATA_O_MSB:0] r_lut_data;
+      wire [P_DATA_O_MSB:0] w_lut_wdata = {L_DATA_I_REPLI{w_wr_data}};
+      integer               lane;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     : LUT Memory Process
+      // Description : Masked write, registered read, enabled like the BRAM.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin : lut_mem_proc
+        if (w_ce == 1'b1) begin
+          if (w_we == 1'b1) begin
+            for (lane = 0; lane <= P_MASK_MSB; lane = lane+1) begin
+              if (w_mask[lane] == 1'b0) begin
+                mem[r_write_ptr][lane*L_MASK_UNIT +: L_MASK_UNIT] <= w_lut_wdata[lane*L_MASK_UNIT +: L_MASK_UNIT];
+              end
+            end
+          end
+          r_lut_data <= mem[r_read_ptr];
+        end
+      end // lut_mem_proc
+      //
+      assign w_read_data = r_lut_data;
+    end // lut_mem_gen
+  endgenerate
 
   /////////////////////////////////////////////////////////////////////////////
   // Process     :  Read Pointer Process
-  // Description : .
+  // Description : A whole word is readable the clock after its last lane is
+  //               written, one read per clock while the level isn't 0.
   /////////////////////////////////////////////////////////////////////////////
   always @(posedge i_clk) begin : Read_Proc
     if (i_rst == 1'b1) begin
       r_read_ptr <= 0;
-      r_empty    <= 1'b1;
-      r_empty_d  <= 1'b1;
-      r_warmedup <= 1'b0;
-      r_mask     <= L_MASK_INITIAL;
-      r_read_ack <= 1'b0;
     end
-    else if (i_wb4_in_scyc == 1'b1) begin
-      if(r_empty == 1'b1) begin
-        //
-        r_empty_d <= ~i_wb4_in_sstb;
-        r_empty   <= r_empty_d;
-        // After it is warmed up
-        r_read_ptr <= r_read_ptr + {{L_ADDR_MSB{1'b0}}, (i_wb4_in_sstb & r_warmedup)};
-        if (r_mask[P_MASK_MSB] == 1'b0) begin
-          r_mask <= L_MASK_INITIAL;
-        end
-        else begin
-          r_mask <= r_mask << L_MASK_SHIFT_UNIT;
-        end
-      end
-      else if(i_wb4_out_sstb == 1'b1) begin
-        // 
-        r_read_ptr <= r_read_ptr + {{L_ADDR_MSB{1'b0}}, ~w_empty};
-        r_empty    <= w_empty;
-        r_warmedup <= 1'b1;
-      end
-
-      if(i_wb4_out_sstb == 1'b1 && r_empty == 1'b0) begin
-        r_read_ack <= 1'b1;
-      end
-      else begin
-        r_read_ack <= 1'b0;
-      end
+    else begin
+      r_read_ptr <= addr_inc(r_read_ptr, w_lvl_dec);
     end
   end // Read_Proc
-  // 
-  assign o_wb4_out_sack = r_read_ack;
-  // Memory read-address pointer (okay to use binary to address memory)
-  assign o_wb4_out_sstall = r_empty;
 
   /////////////////////////////////////////////////////////////////////////////
-  // Process     :  Write Pointer Process
+  // Process     :  Read Ack Process
   // Description : .
   /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : read_ack_proc
+    if (i_rst == 1'b1 || w_rd_cyc == 1'b0) begin
+      r_read_ack <= 1'b0;
+    end
+    else begin
+      r_read_ack <= w_lvl_dec;
+    end
+  end // read_ack_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Pointer Process
+  // Description : The input words go into the lanes of the word at the write
+  //               pointer, it moves on once the word is complete or flushed.
+  /////////////////////////////////////////////////////////////////////////////
   always @(posedge i_clk) begin : Write_Proc
     if (i_rst == 1'b1) begin
       r_write_ptr <= 'h0;
-      r_full      <= 1'b0;
-      r_write_ack <= 1'b0;
+      r_unit_cnt  <= 'h0;
     end
-    else if (i_wb4_in_scyc == 1'b1) begin
-      if (w_we == 1'b1) begin
-        r_write_ptr <= r_write_ptr + 1;
-        r_full      <= w_full;
-        r_write_ack <= 1'b1;
+    else begin
+      r_write_ptr <= addr_inc(r_write_ptr, w_lvl_inc);
+      if (w_lvl_inc == 1'b1) begin
+        r_unit_cnt <= 'h0;
       end
-      else begin
-        //
-        r_write_ack <= 1'b0;
+      else if (w_we == 1'b1) begin
+        r_unit_cnt <= r_unit_cnt + 1;
       end
     end
   end // Write_Proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Ack Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : write_ack_proc
+    if (i_rst == 1'b1 || w_wr_cyc == 1'b0) begin
+      r_write_ack <= 1'b0;
+    end
+    else begin
+      r_write_ack <= w_we;
+    end
+  end // write_ack_proc
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Fill Level Process
+  // Description : Counts complete output words. Level and flags are
+  //               registered from the next state count.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : level_proc
+    if (i_rst == 1'b1) begin
+      r_level        <= 'h0;
+      r_almost_full  <= 1'b0;
+      r_almost_empty <= 1'b1;
+    end
+    else begin
+      r_level        <= w_level_next;
+      r_almost_full  <= (w_level_next >= i_wb4_in_afull_thresh) ? 1'b1 : 1'b0;
+      r_almost_empty <= (w_level_next <= i_wb4_out_aempty_thresh) ? 1'b1 : 1'b0;
+    end
+  end // level_proc
   //
-  assign o_wb4_in_sack = r_write_ack;
-  // Memory read-address pointer (okay to use binary to address memory)
-  assign o_wb4_in_sstall = w_full;
+  assign o_wb4_in_level         = r_level;
+  assign o_wb4_in_almost_full   = r_almost_full;
+  assign o_wb4_out_level        = r_level;
+  assign o_wb4_out_almost_empty = r_almost_empty;
+
+  generate
+    if (P_SKID_BUFFER == 1) begin: skid_buffer_gen
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Write Skid Buffer
+      // Description : Registered STALL and DAT on the write port.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_wr_skid_buffer #(
+        .P_DATA_MSB(P_DATA_I_MSB)
+      ) wr_skid_buffer_inst (
+        .i_clk   (i_clk                                          ),
+        .i_rst   (i_rst                                          ),
+        .i_cyc   (i_wb4_in_scyc                                  ),
+        .i_stb   (i_wb4_in_sstb                                  ),
+        .i_data  (i_wb4_in_sdata                                 ),
+        .o_ack   (o_wb4_in_sack                                  ),
+        .o_stall (o_wb4_in_sstall                                ),
+        .o_cyc   (w_wr_cyc                                       ),
+        .o_stb   (w_wr_stb                                       ),
+        .o_data  (w_wr_data                                      ),
+        .i_accept(w_we                                           )
+      );
+
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Read Skid Buffer
+      // Description : Registered STALL and DAT on the read port. The buffer pops
+      //               one word at a time, no bursts on the FIFO side. A pop is
+      //               taken under the same conditions read_ack_proc acks it.
+      ///////////////////////////////////////////////////////////////////////////////
+      wb4_rd_skid_buffer #(
+        .P_DATA_MSB(P_DATA_O_MSB)
+      ) rd_skid_buffer_inst (
+        .i_clk   (i_clk                                        ),
+        .i_rst   (i_rst                                        ),
+        .i_cyc   (i_wb4_out_scyc                               ),
+        .i_stb   (i_wb4_out_sstb                               ),
+        .o_ack   (o_wb4_out_sack                               ),
+        .o_data  (o_wb4_out_sdata                              ),
+        .o_stall (o_wb4_out_sstall                             ),
+        .o_cyc   (w_rd_cyc                                     ),
+        .o_stb   (w_rd_stb                                     ),
+        .i_accept(w_lvl_dec                                    ),
+        .i_ack   (r_read_ack                                   ),
+        .i_data  (w_read_data                                  )
+      );
+    end // skid_buffer_gen
+    else begin: no_skid_buffer_gen
+      // Write port
+      assign w_wr_cyc        = i_wb4_in_scyc;
+      assign w_wr_stb        = i_wb4_in_sstb;
+      assign w_wr_data       = i_wb4_in_sdata;
+      assign o_wb4_in_sack   = r_write_ack;
+      assign o_wb4_in_sstall = w_full;
+      // Read port
+      assign w_rd_cyc         = i_wb4_out_scyc;
+      assign w_rd_stb         = i_wb4_out_sstb;
+      assign o_wb4_out_sack   = r_read_ack;
+      assign o_wb4_out_sdata  = w_read_data;
+      assign o_wb4_out_sstall = w_empty;
+    end // no_skid_buffer_gen
+  endgenerate
 
 endmodule // wb4_sync_fifo_N_to_1
@@ -0,0 +1,216 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_sync_fifo_multi_lane.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_sync_fifo_multi_lane
+Description  : Wishbone B4(pipelined) Sync FIFO moving up to P_LANES words per
+               clock on each port.
+
+Additional Comments:
+   The storage is split in P_LANES generic_sbram banks, entry n lives in bank
+   n%P_LANES at address n/P_LANES, so any P_LANES consecutive entries hit every
+   bank once. The write lanes are rotated onto the banks by the write pointer
+   and the bank outputs are rotated back onto the read lanes by the read
+   pointer. Lane 0 is always the oldest word.
+   Write beat : i_wb4_in_scount words (1 to P_LANES) from lane 0 up, stalled
+                until they all fit.
+   Read beat  : i_wb4_out_scount words are popped, stalled until that many are
+                stored. o_wb4_out_savail tells how many could be popped now.
+                The data is returned with the ack on the next clock.
+   A count above P_LANES is taken as P_LANES on both ports.
+*/
+module wb4_sync_fifo_multi_lane #(
+  parameter integer P_DATA_MSB = 7,   // Lane Width-1
+  parameter integer P_LANES    = 4,   // Words per clock, power of 2
+  parameter integer P_DEPTH    = 128  // FIFO Depth in words, power of 2
+)(
+  // Component's clocks and resets
+  input i_clk, // clock
+  input i_rst, // reset
+  // Write Interface  Signals
+  input                                 i_wb4_in_scyc,   // Enable
+  input                                 i_wb4_in_sstb,   // Write Strobe
+  output                                o_wb4_in_sack,   // Write Acknowledge
+  input  [(P_LANES*(P_DATA_MSB+1))-1:0] i_wb4_in_sdata,  // Write Data, lane 0 first
+  input  [$clog2(P_LANES):0]            i_wb4_in_scount, // Valid lanes in this beat
+  output                                o_wb4_in_sstall, // Not enough room?
+  output [$clog2(P_DEPTH):0]            o_wb4_in_level,  // Entries in use
+  // Read Interface Signals
+  input                                 i_wb4_out_scyc,   // Read Cycle
+  input                                 i_wb4_out_sstb,   // Read Strobe
+  output                                o_wb4_out_sack,   // Read Acknowledge
+  output [(P_LANES*(P_DATA_MSB+1))-1:0] o_wb4_out_sdata,  // Read Data, lane 0 first
+  input  [$clog2(P_LANES):0]            i_wb4_out_scount, // Lanes requested in this beat
+  output [$clog2(P_LANES):0]            o_wb4_out_savail, // Lanes available now
+  output                                o_wb4_out_sstall, // Not enough words?
+  output [$clog2(P_DEPTH):0]            o_wb4_out_level   // Entries in use
+);
+
+/*verilator coverage_off*/
+  ///////////////////////////////////////////////////////////////////////////////
+  // Parameters Check
+  ///////////////////////////////////////////////////////////////////////////////
+  initial begin
+    if(P_LANES < 2 || (P_LANES & (P_LANES-1)) != 0 || (P_DEPTH & (P_DEPTH-1)) != 0 || P_DEPTH < 2*P_LANES) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_sync_fifo_multi_lane");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_LANES: %0d", P_LANES);
+      $display("    P_DEPTH: %0d", P_DEPTH);
+      $display("  description: P_LANES (>=2) and P_DEPTH must be powers of 2, P_DEPTH >= 2*P_LANES so every bank holds 2 words or more.");
+    end
+  end
+/*verilator coverage_on*/
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_WIDTH     = P_DATA_MSB+1;
+  localparam integer L_LANE_MSB  = $clog2(P_LANES)-1;
+  localparam integer L_CNT_MSB   = L_LANE_MSB+1;
+  localparam integer L_ADDR_MSB  = $clog2(P_DEPTH)-1;
+  localparam integer L_BANK_MSB  = L_ADDR_MSB-L_CNT_MSB; // Bank address MSB
+  // The pointers carry one extra wrap bit so all P_DEPTH entries are usable.
+  localparam integer L_PTR_MSB   = L_ADDR_MSB+1;
+  localparam integer L_PTR_PAD   = L_PTR_MSB-L_CNT_MSB;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Write Proc
+  reg [L_PTR_MSB:0] r_write_ptr;
+  reg               r_write_ack;
+  // Read Proc
+  reg [L_PTR_MSB:0]  r_read_ptr;
+  reg [L_LANE_MSB:0] r_read_rot; // Bank holding lane 0 of the beat being acked
+  reg                r_read_ack;
+  // Level Proc
+  reg [L_PTR_MSB:0] r_level;
+  // Banks
+  wire [(P_LANES*L_WIDTH)-1:0] w_bank_rdata;
+  //
+  wire w_ce = !i_rst;
+  // Lane counts, clamped to P_LANES
+  wire [L_CNT_MSB:0] w_in_count  = (i_wb4_in_scount > P_LANES) ? P_LANES : i_wb4_in_scount;
+  wire [L_CNT_MSB:0] w_out_count = (i_wb4_out_scount > P_LANES) ? P_LANES : i_wb4_out_scount;
+  // Write Controls Asynch Logic
+  wire [L_PTR_MSB:0] w_room = P_DEPTH-r_level;
+  wire               w_we   = i_wb4_in_scyc & i_wb4_in_sstb;
+  wire               w_push = w_we && (w_room >= w_in_count);
+  wire [L_PTR_MSB:0] w_write_ptr_next = r_write_ptr + ((w_push == 1'b1) ? {{L_PTR_PAD{1'b0}}, w_in_count} : 0);
+  // Read Controls Asynch Logic
+  wire               w_re  = i_wb4_out_scyc & i_wb4_out_sstb;
+  wire               w_pop = w_re && (r_level >= w_out_count);
+  wire [L_PTR_MSB:0] w_read_ptr_next = r_read_ptr + ((w_pop == 1'b1) ? {{L_PTR_PAD{1'b0}}, w_out_count} : 0);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write Pointer Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : write_proc
+    if (i_rst == 1'b1) begin
+      r_write_ptr <= 'h0;
+      r_write_ack <= 1'b0;
+    end
+    else begin
+      r_write_ptr <= w_write_ptr_next;
+      r_write_ack <= w_push;
+    end
+  end // write_proc
+  //
+  assign o_wb4_in_sack   = r_write_ack;
+  assign o_wb4_in_sstall = (w_room < w_in_count) ? 1'b1 : 1'b0;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read Pointer Process
+  // Description : The banks register their output on the pop edge, the
+  //               rotation is registered with it.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : read_proc
+    if (i_rst == 1'b1) begin
+      r_read_ptr <= 'h0;
+      r_read_rot <= 'h0;
+      r_read_ack <= 1'b0;
+    end
+    else begin
+      r_read_ptr <= w_read_ptr_next;
+      r_read_rot <= r_read_ptr[L_LANE_MSB:0];
+      r_read_ack <= w_pop;
+    end
+  end // read_proc
+  //
+  assign o_wb4_out_sack   = r_read_ack;
+  assign o_wb4_out_sstall = (r_level < w_out_count) ? 1'b1 : 1'b0;
+  assign o_wb4_out_savail = (r_level >= P_LANES) ? P_LANES : r_level[L_CNT_MSB:0];
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Fill Level Process
+  // Description : Registered from the next state pointers.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : level_proc
+    if (i_rst == 1'b1) begin
+      r_level <= 'h0;
+    end
+    else begin
+      r_level <= w_write_ptr_next - w_read_ptr_next;
+    end
+  end // level_proc
+  //
+  assign o_wb4_in_level  = r_level;
+  assign o_wb4_out_level = r_level;
+
+  genvar bank;
+  generate
+    for (bank = 0; bank < P_LANES; bank = bank+1) begin: bank_gen
+      // Lane that lands in / is read from this bank, relative to the pointers.
+      wire [L_LANE_MSB:0] w_wr_lane  = bank - r_write_ptr[L_LANE_MSB:0];
+      wire [L_LANE_MSB:0] w_rd_lane  = bank - r_read_ptr[L_LANE_MSB:0];
+      wire [L_PTR_MSB:0]  w_wr_entry = r_write_ptr + {{L_PTR_PAD{1'b0}}, {1'b0, w_wr_lane}};
+      wire [L_PTR_MSB:0]  w_rd_entry = r_read_ptr + {{L_PTR_PAD{1'b0}}, {1'b0, w_rd_lane}};
+      wire                w_bank_we  = w_push && ({1'b0, w_wr_lane} < w_in_count);
+      // Lane this bank feeds on the read port.
+      wire [L_LANE_MSB:0] w_out_bank = r_read_rot + bank;
+
+      ///////////////////////////////////////////////////////////////////////////////
+      // Instance    : Bank BRAM
+      // Description : Inferrable Single Port Block RAM.
+      ///////////////////////////////////////////////////////////////////////////////
+      generic_sbram #(
+        // Compile time configurable parameters
+        .P_SBRAM_DATA_MSB (P_DATA_MSB),
+        .P_SBRAM_ADDR_MSB (L_BANK_MSB),
+        .P_SBRAM_MASK_MSB (0),
+        .P_SBRAM_HAS_FILE (0),
+        .P_SBRAM_INIT_FILE(0)
+      ) fifo_bank_inst (
+        .i_ce   (w_ce                                         ),
+        .i_wclk (i_clk                                        ),
+        .i_rclk (i_clk                                        ),
+        .i_waddr(w_wr_entry[L_ADDR_MSB:L_CNT_MSB]             ),
+        .i_raddr(w_rd_entry[L_ADDR_MSB:L_CNT_MSB]             ),
+        .i_we   (w_bank_we                                    ),
+        .i_mask (0                                            ), // 0=writes, 1=masks
+        .i_wdata(i_wb4_in_sdata[w_wr_lane*L_WIDTH +: L_WIDTH] ),
+        .o_rdata(w_bank_rdata[bank*L_WIDTH +: L_WIDTH]        )
+      );
+      // Read lane "bank" comes from bank r_read_rot+bank.
+      assign o_wb4_out_sdata[bank*L_WIDTH +: L_WIDTH] = w_bank_rdata[w_out_bank*L_WIDTH +: L_WIDTH];
+    end // bank_gen
+  endgenerate
+
+endmodule // wb4_sync_fifo_multi_lane
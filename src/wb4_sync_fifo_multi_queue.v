@@ -0,0 +1,217 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_sync_fifo_multi_queue.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_sync_fifo_multi_queue
+Description  : Wishbone B4(pipelined) Sync FIFO holding P_CHANNELS independent
+               queues in one generic_sbram.
+
+Additional Comments:
+   The memory is split in P_CHANNELS regions of P_CH_DEPTH words, the channel
+   number is the upper part of the address. Every queue has its own write and
+   read pointers, full/empty flags and level. The channel of each beat comes
+   on the i_wb4_in_schan/i_wb4_out_schan side band and STALL follows the flag
+   of the selected queue, so beats to different channels can be interleaved
+   on every clock. Every channel has the same one clock read latency, the
+   data comes with the ACK.
+*/
+module wb4_sync_fifo_multi_queue #(
+  parameter integer P_DATA_MSB  = 7,  // FIFO Width-1
+  parameter integer P_CHANNELS  = 4,  // Queues, power of 2
+  parameter integer P_CH_DEPTH  = 32  // Depth of every queue, power of 2
+)(
+  // Component's clocks and resets
+  input i_clk, // clock
+  input i_rst, // reset
+  // Write Interface  Signals
+  input                            i_wb4_in_scyc,   // Enable
+  input                            i_wb4_in_sstb,   // Write Strobe
+  output                           o_wb4_in_sack,   // Write Acknowledge
+  input  [P_DATA_MSB:0]            i_wb4_in_sdata,  // Write Data
+  input  [$clog2(P_CHANNELS)-1:0]  i_wb4_in_schan,  // Queue to write
+  output                           o_wb4_in_sstall, // Selected queue full?
+  output [P_CHANNELS-1:0]          o_wb4_in_full,   // Full flag per queue
+  // Read Interface Signals
+  input                            i_wb4_out_scyc,   // Read Cycle
+  input                            i_wb4_out_sstb,   // Read Strobe
+  output                           o_wb4_out_sack,   // Read Acknowledge
+  output [P_DATA_MSB:0]            o_wb4_out_sdata,  // Read Data
+  input  [$clog2(P_CHANNELS)-1:0]  i_wb4_out_schan,  // Queue to read
+  output                           o_wb4_out_sstall, // Selected queue empty?
+  output [P_CHANNELS-1:0]          o_wb4_out_empty,  // Empty flag per queue
+  // Fill Level per queue, queue 0 in the lowest bits
+  output [(P_CHANNELS*($clog2(P_CH_DEPTH)+1))-1:0] o_wb4_level // Entries in use
+);
+
+/*verilator coverage_off*/
+  ///////////////////////////////////////////////////////////////////////////////
+  // Parameters Check
+  ///////////////////////////////////////////////////////////////////////////////
+  initial begin
+    if(P_CHANNELS < 2 || (P_CHANNELS & (P_CHANNELS-1)) != 0 || (P_CH_DEPTH & (P_CH_DEPTH-1)) != 0) begin
+      $display("[COMPILE-ERROR]");
+      $display("  source: wb4_sync_fifo_multi_queue");
+      $display("  type: Parameter");
+      $display("  parameters:");
+      $display("    P_CHANNELS: %0d", P_CHANNELS);
+      $display("    P_CH_DEPTH: %0d", P_CH_DEPTH);
+      $display("  description: P_CHANNELS (>=2) and P_CH_DEPTH must be powers of 2.");
+    end
+  end
+/*verilator coverage_on*/
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Parameter Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  localparam integer L_CH_MSB   = $clog2(P_CHANNELS)-1;
+  localparam integer L_ADDR_MSB = $clog2(P_CH_DEPTH)-1;
+  // The pointers carry one extra wrap bit so all P_CH_DEPTH entries are usable.
+  localparam integer L_PTR_MSB  = L_ADDR_MSB+1;
+  localparam integer L_PTR_W    = L_PTR_MSB+1;
+  localparam integer L_PTR_PAD  = L_PTR_MSB;
+  // Memory address, {channel, entry}
+  localparam integer L_MEM_MSB  = L_CH_MSB+L_ADDR_MSB+1;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  // Per queue pointers and level, queue 0 in the lowest bits
+  wire [(P_CHANNELS*L_PTR_W)-1:0] w_wr_ptrs;
+  wire [(P_CHANNELS*L_PTR_W)-1:0] w_rd_ptrs;
+  wire [(P_CHANNELS*L_PTR_W)-1:0] w_levels;
+  wire [P_CHANNELS-1:0]           w_full;
+  wire [P_CHANNELS-1:0]           w_empty;
+  // Write Proc
+  reg r_write_ack;
+  // Read Proc
+  reg r_read_ack;
+  //
+  wire w_ce = !i_rst;
+  // Selected queues
+  wire [L_PTR_MSB:0] w_wr_ptr    = w_wr_ptrs[i_wb4_in_schan*L_PTR_W +: L_PTR_W];
+  wire [L_PTR_MSB:0] w_rd_ptr    = w_rd_ptrs[i_wb4_out_schan*L_PTR_W +: L_PTR_W];
+  wire [L_PTR_MSB:0] w_wr_level  = w_levels[i_wb4_in_schan*L_PTR_W +: L_PTR_W];
+  wire [L_PTR_MSB:0] w_rd_level  = w_levels[i_wb4_out_schan*L_PTR_W +: L_PTR_W];
+  // Write Controls Asynch Logic
+  wire w_push = i_wb4_in_scyc & i_wb4_in_sstb & ~w_full[i_wb4_in_schan];
+  // Read Controls Asynch Logic
+  wire w_pop  = i_wb4_out_scyc & i_wb4_out_sstb & ~w_empty[i_wb4_out_schan];
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  genvar chan;
+  generate
+    for (chan = 0; chan < P_CHANNELS; chan = chan+1) begin: queue_gen
+      reg  [L_PTR_MSB:0] r_wr_ptr;
+      reg  [L_PTR_MSB:0] r_rd_ptr;
+      reg  [L_PTR_MSB:0] r_level;
+      reg                r_full;
+      reg                r_empty;
+      wire               w_wr_inc = (w_push == 1'b1 && i_wb4_in_schan == chan) ? 1'b1 : 1'b0;
+      wire               w_rd_inc = (w_pop == 1'b1 && i_wb4_out_schan == chan) ? 1'b1 : 1'b0;
+      wire [L_PTR_MSB:0] w_wr_ptr_next = r_wr_ptr + {{L_PTR_PAD{1'b0}}, {w_wr_inc}};
+      wire [L_PTR_MSB:0] w_rd_ptr_next = r_rd_ptr + {{L_PTR_PAD{1'b0}}, {w_rd_inc}};
+      wire [L_PTR_MSB:0] w_level_next  = w_wr_ptr_next - w_rd_ptr_next;
+
+      /////////////////////////////////////////////////////////////////////////////
+      // Process     :  Queue Process
+      // Description : Pointers, level and flags of one queue, registered from
+      //               the next state pointers.
+      /////////////////////////////////////////////////////////////////////////////
+      always @(posedge i_clk) begin : queue_proc
+        if (i_rst == 1'b1) begin
+          r_wr_ptr <= 'h0;
+          r_rd_ptr <= 'h0;
+          r_level  <= 'h0;
+          r_full   <= 1'b0;
+          r_empty  <= 1'b1;
+        end
+        else begin
+          r_wr_ptr <= w_wr_ptr_next;
+          r_rd_ptr <= w_rd_ptr_next;
+          r_level  <= w_level_next;
+          r_full   <= (w_level_next == P_CH_DEPTH) ? 1'b1 : 1'b0;
+          r_empty  <= (w_level_next == 0) ? 1'b1 : 1'b0;
+        end
+      end // queue_proc
+      //
+      assign w_wr_ptrs[chan*L_PTR_W +: L_PTR_W] = r_wr_ptr;
+      assign w_rd_ptrs[chan*L_PTR_W +: L_PTR_W] = r_rd_ptr;
+      assign w_levels[chan*L_PTR_W +: L_PTR_W]  = r_level;
+      assign w_full[chan]                       = r_full;
+      assign w_empty[chan]                      = r_empty;
+    end // queue_gen
+  endgenerate
+  //
+  assign o_wb4_in_full   = w_full;
+  assign o_wb4_out_empty = w_empty;
+  assign o_wb4_level     = w_levels;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write ACK Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : write_ack_proc
+    if (i_rst == 1'b1 || i_wb4_in_scyc == 1'b0) begin
+      r_write_ack <= 1'b0;
+    end
+    else begin
+      r_write_ack <= w_push;
+    end
+  end // write_ack_proc
+  //
+  assign o_wb4_in_sack   = r_write_ack;
+  assign o_wb4_in_sstall = w_full[i_wb4_in_schan];
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Read ACK Process
+  // Description : The BRAM output register holds the popped word.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : read_ack_proc
+    if (i_rst == 1'b1 || i_wb4_out_scyc == 1'b0) begin
+      r_read_ack <= 1'b0;
+    end
+    else begin
+      r_read_ack <= w_pop;
+    end
+  end // read_ack_proc
+  //
+  assign o_wb4_out_sack   = r_read_ack;
+  assign o_wb4_out_sstall = w_empty[i_wb4_out_schan];
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Instance    : Single Port BRAM
+  // Description : Inferrable Single Port Block RAM shared by all the queues.
+  ///////////////////////////////////////////////////////////////////////////////
+  generic_sbram #(
+    // Compile time configurable parameters
+    .P_SBRAM_DATA_MSB (P_DATA_MSB),
+    .P_SBRAM_ADDR_MSB (L_MEM_MSB),
+    .P_SBRAM_MASK_MSB (0),
+    .P_SBRAM_HAS_FILE (0),
+    .P_SBRAM_INIT_FILE(0)
+  ) fifo_mem_inst (
+    .i_ce   (w_ce                                   ),
+    .i_wclk (i_clk                                  ),
+    .i_rclk (i_clk                                  ),
+    .i_waddr({i_wb4_in_schan, w_wr_ptr[L_ADDR_MSB:0]} ),
+    .i_raddr({i_wb4_out_schan, w_rd_ptr[L_ADDR_MSB:0]}),
+    .i_we   (w_push                                 ),
+    .i_mask (0                                      ), // 0=writes, 1=masks
+    .i_wdata(i_wb4_in_sdata                         ),
+    .o_rdata(o_wb4_out_sdata                        )
+  );
+
+endmodule // wb4_sync_fifo_multi_queue
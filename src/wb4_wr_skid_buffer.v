@@ -0,0 +1,112 @@
+/*
+ 
+Copyright (c) 2023, Jose R. Garcia (jg-fossh@protonmail.com)
+All rights reserved.
+
+The following hardware description source code is subject to the terms of the
+                 Open Hardware Description License, v. 1.0
+If a copy of the afromentioned license was not distributed with this file you
+can obtain one at http://juliusbaxter.net/ohdl/ohdl.txt
+
+--------------------------------------------------------------------------------
+File name    : wb4_wr_skid_buffer.v
+Author       : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name : Wishbone B4 FIFO Library
+Module Name  : wb4_wr_skid_buffer
+Description  : Wishbone B4(pipelined) write port skid buffer, registered STALL
+               and DAT in front of a FIFO write port.
+
+Additional Comments:
+   The master sees a STALL that comes straight from a flop. A beat is taken
+   into the output register and presented to the FIFO port from there; when
+   the FIFO doesn't accept it the next beat lands in the skid register and
+   STALL rises on the following clock. Back to back beats go through at one
+   per clock as long as the FIFO accepts them. A beat is acked when it is
+   taken, it is already committed to reach the FIFO.
+   i_data carries whatever must travel with the beat (e.g. {SEL, DAT}).
+*/
+module wb4_wr_skid_buffer #(
+  parameter integer P_DATA_MSB = 7 // Payload Width-1
+)(
+  input i_clk, // clock
+  input i_rst, // reset
+  // Master Side
+  input                 i_cyc,   // Cycle
+  input                 i_stb,   // Strobe
+  input  [P_DATA_MSB:0] i_data,  // Payload
+  output                o_ack,   // Acknowledge
+  output                o_stall, // Registered Stall
+  // FIFO Side
+  output                o_cyc,   // Cycle, held while a beat is pending
+  output                o_stb,   // Strobe
+  output [P_DATA_MSB:0] o_data,  // Registered Payload
+  input                 i_accept // The FIFO took the beat this clock
+);
+
+  ///////////////////////////////////////////////////////////////////////////////
+  // Internal Signals Declarations
+  ///////////////////////////////////////////////////////////////////////////////
+  reg                r_out_valid;
+  reg [P_DATA_MSB:0] r_out_data;
+  reg                r_skid_valid;
+  reg [P_DATA_MSB:0] r_skid_data;
+  reg                r_ack;
+  //
+  wire w_take = i_cyc & i_stb & ~r_skid_valid;
+  wire w_free = ~r_out_valid | i_accept;
+
+  ///////////////////////////////////////////////////////////////////////////////
+  //            ********      Architecture Declaration      ********           //
+  ///////////////////////////////////////////////////////////////////////////////
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Skid Process
+  // Description : The skid register refills the output register first, a new
+  //               beat only goes to the skid register when the output
+  //               register is still held by the FIFO.
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : skid_proc
+    if (i_rst == 1'b1) begin
+      r_out_valid  <= 1'b0;
+      r_out_data   <= 0;
+      r_skid_valid <= 1'b0;
+      r_skid_data  <= 0;
+    end
+    else if (w_free == 1'b1) begin
+      if (r_skid_valid == 1'b1) begin
+        r_out_valid  <= 1'b1;
+        r_out_data   <= r_skid_data;
+        r_skid_valid <= 1'b0;
+      end
+      else begin
+        r_out_valid <= w_take;
+        r_out_data  <= i_data;
+      end
+    end
+    else if (w_take == 1'b1) begin
+      r_skid_valid <= 1'b1;
+      r_skid_data  <= i_data;
+    end
+  end // skid_proc
+  //
+  assign o_stall = r_skid_valid;
+  assign o_cyc   = i_cyc | r_out_valid;
+  assign o_stb   = r_out_valid;
+  assign o_data  = r_out_data;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process     :  Write ACK Process
+  // Description : .
+  /////////////////////////////////////////////////////////////////////////////
+  always @(posedge i_clk) begin : ack_proc
+    if (i_rst == 1'b1 || i_cyc == 1'b0) begin
+      r_ack <= 1'b0;
+    end
+    else begin
+      r_ack <= w_take;
+    end
+  end // ack_proc
+  //
+  assign o_ack = r_ack;
+
+endmodule // wb4_wr_skid_buffer
@@ -0,0 +1,69 @@
+/* 
+ 
+ Copyright (c) 2025, Jose R. Garcia (jg-fossh@protonmail.com)
+ All rights reserved.
+
+ 
+    Licensed under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in
+    compliance with the License.  You may obtain a copy of
+    the License at
+ 
+        http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in
+    writing, software distributed under the License is
+    distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+    CONDITIONS OF ANY KIND, either express or implied.  See
+    the License for the specific language governing
+    permissions and limitations under the License.
+
+--------------------------------------------------------------------------------
+File name      : ack_rate_subscriber.h
+Author         : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name   : Wishbone B4 FIFO Library
+Class(es) Name : ack_rate_subscriber
+Description    : Time stamps every transaction published by a monitor so a
+                 test can check how many clocks a burst of acks took.
+                 Shared by the sync and the dual clock FIFO benches.
+
+Additional Comments:
+ 
+*/
+
+#ifndef ACK_RATE_SUBSCRIBER_H_
+#define ACK_RATE_SUBSCRIBER_H_
+
+#include <vector>
+
+#include <systemc>
+#include <uvm>
+
+//--------------------------------------------------------------------------
+// Class : ack_rate_subscriber
+// Description :
+//--------------------------------------------------------------------------
+class ack_rate_subscriber : public uvm::uvm_subscriber<wb4_seq_item> {
+public:
+
+  std::vector<sc_core::sc_time> stamps;
+
+  UVM_COMPONENT_UTILS(ack_rate_subscriber);
+
+  ack_rate_subscriber(uvm::uvm_component_name name = "ack_rate_subscriber")
+    : uvm::uvm_subscriber<wb4_seq_item>(name) {}
+
+  void write(const wb4_seq_item& t) override {
+    stamps.push_back(sc_core::sc_time_stamp());
+  }
+
+  // Acks per clock between the first and the last recorded ack.
+  double rate(const sc_core::sc_time& period) const {
+    if(stamps.size() < 2)
+      return 0.0;
+    double clks = (stamps.back() - stamps.front()) / period + 1.0;
+    return static_cast<double>(stamps.size()) / clks;
+  }
+}; // ack_rate_subscriber
+
+#endif /* ACK_RATE_SUBSCRIBER_H_ */
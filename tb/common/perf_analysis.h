@@ -0,0 +1,304 @@
+/* 
+ 
+ Copyright (c) 2025, Jose R. Garcia (jg-fossh@protonmail.com)
+ All rights reserved.
+
+ 
+    Licensed under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in
+    compliance with the License.  You may obtain a copy of
+    the License at
+ 
+        http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in
+    writing, software distributed under the License is
+    distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+    CONDITIONS OF ANY KIND, either express or implied.  See
+    the License for the specific language governing
+    permissions and limitations under the License.
+
+--------------------------------------------------------------------------------
+File name      : perf_analysis.h
+Author         : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name   : Wishbone B4 FIFO Library
+Class(es) Name : perf_analysis
+Description    : Write-to-read latency, throughput and stall statistics.
+                 Shared by the sync and the dual clock FIFO benches.
+
+Additional Comments:
+  Every write is time stamped on its ACK and matched in FIFO order, through
+  the predictor's bit stream: a write is read once the predictor's read
+  position passed the last of its bits, so width conversion and repeated
+  data values match the same way. tb_env connects it after the predictor,
+  the predictor has already moved its positions for every item seen here.
+  A read whose data differs from the predictor's expectation is counted as
+  a mismatch, writes the predictor rolled back (aborted frames) as dropped
+  and a word skipped through the peek port as read by the next read.
+  Latencies are kept as a histogram in ps, so the memory only grows with
+  the number of distinct latencies, and are reported in cycles of both
+  clocks. The ACKs are counted per window of window_clks clocks of each port
+  and the strobes held by STALL give the stall-cycle ratio.
+  report_phase writes perf.json, perf_latency.csv and perf_throughput.csv
+  next to logs/coverage.dat.
+ 
+*/
+
+#ifndef PERF_ANALYSIS_H_
+#define PERF_ANALYSIS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <systemc>
+#include <uvm>
+
+//--------------------------------------------------------------------------
+// Class : perf_analysis
+// Description :
+//--------------------------------------------------------------------------
+class perf_analysis : public uvm::uvm_component {
+public:
+  int window_clks;
+  predictor* prd;
+  wb4_bfm* in_vif;
+  wb4_bfm* out_vif;
+  uvm::uvm_analysis_export<wb4_seq_item> in_ap;
+  uvm::uvm_analysis_export<wb4_seq_item> out_ap;
+
+    class in_subscriber : public uvm::uvm_subscriber<wb4_seq_item> {
+    public:
+        perf_analysis* perf;
+
+        in_subscriber(const uvm::uvm_component_name& name, perf_analysis* perf)
+            : uvm_subscriber<wb4_seq_item>(name), perf(perf) {}
+
+        void write(const wb4_seq_item& t) override {
+            perf->write_in(t);
+        }
+    };
+
+    class out_subscriber : public uvm::uvm_subscriber<wb4_seq_item> {
+    public:
+        perf_analysis* perf;
+
+        out_subscriber(const uvm::uvm_component_name& name, perf_analysis* perf)
+            : uvm_subscriber<wb4_seq_item>(name), perf(perf) {}
+
+        void write(const wb4_seq_item& t) override {
+            perf->write_out(t);
+        }
+    };
+
+    in_subscriber  in_writer;
+    out_subscriber out_writer;
+
+  SC_HAS_PROCESS(perf_analysis);
+  // Provide implementations of virtual methods such as get_type_name and create
+  UVM_COMPONENT_UTILS(perf_analysis);
+
+
+    perf_analysis(uvm::uvm_component_name name="perf_analysis")
+        : uvm::uvm_component(name), window_clks(256),
+          prd(nullptr), in_vif(nullptr), out_vif(nullptr),
+          in_ap("in_ap"),
+          out_ap("out_ap"),
+          in_writer("in_writer", this),
+          out_writer("out_writer", this),
+          m_in_pos(0), m_out_pos(0), m_dropped(0), m_mismatches(0) {
+      SC_THREAD(write_port);
+      SC_THREAD(read_port);
+    }
+
+
+    virtual void connect_phase(uvm::uvm_phase& phase) {
+        in_ap.connect(in_writer.analysis_export);
+        out_ap.connect(out_writer.analysis_export);
+    }
+
+    void write_in(const wb4_seq_item& trans) {
+      drop_rolled_back();
+      if(prd->in_position() > m_in_pos) { // Refused writes don't move it
+        m_in_pos = prd->in_position();
+        m_inflight.push_back(std::make_pair(m_in_pos, sc_core::sc_time_stamp()));
+      }
+    }
+
+    void write_out(const wb4_seq_item& trans) {
+      drop_rolled_back();
+      if(prd->out_position() == m_out_pos) // Refused, nothing was read
+        return;
+      m_out_pos = prd->out_position();
+      if((uint64_t)trans.dat_i != (uint64_t)prd->expected().dat_i)
+        m_mismatches++;
+      while(!m_inflight.empty() && m_inflight.front().first <= m_out_pos) {
+        m_latency[ps(sc_core::sc_time_stamp() - m_inflight.front().second)]++;
+        m_inflight.pop_front();
+      }
+    }
+
+
+    virtual void report_phase(uvm::uvm_phase& phase) {
+      std::string uvmtest_name;
+      if(!uvm::uvm_config_db<std::string>::get(this, "*", "uvmtest_name", uvmtest_name))
+        UVM_FATAL("NOTST", "Test name not in the config_db: " + get_full_name() + ".uvmtest_name");
+      std::string logs = uvmtest_name+"/logs/";
+      Verilated::mkdir((uvmtest_name+"/").c_str());
+      Verilated::mkdir(logs.c_str());
+
+      uint64_t samples = 0;
+      double   sum     = 0.0;
+      for(const auto& bin : m_latency) {
+        samples += bin.second;
+        sum     += (double)bin.first * bin.second;
+      }
+
+      std::ofstream json(logs+"perf.json");
+      json << "{\n";
+      json << "  \"latency\": {\n";
+      json << "    \"samples\": " << samples << ",\n";
+      json << "    \"unmatched_writes\": " << m_inflight.size() << ",\n";
+      json << "    \"dropped_writes\": " << m_dropped << ",\n";
+      json << "    \"mismatched_reads\": " << m_mismatches << ",\n";
+      json << "    \"in_clk_cycles\": " << stats_json(samples, sum, m_in.period) << ",\n";
+      json << "    \"out_clk_cycles\": " << stats_json(samples, sum, m_out.period) << "\n";
+      json << "  },\n";
+      json << "  \"throughput\": {\n";
+      json << "    \"window_clks\": " << window_clks << ",\n";
+      json << "    \"in\": " << windows_json(m_in) << ",\n";
+      json << "    \"out\": " << windows_json(m_out) << "\n";
+      json << "  },\n";
+      json << "  \"stall_ratio\": {\n";
+      json << "    \"in\": " << stall_ratio(m_in) << ",\n";
+      json << "    \"out\": " << stall_ratio(m_out) << "\n";
+      json << "  }\n";
+      json << "}\n";
+
+      std::ofstream hist(logs+"perf_latency.csv");
+      hist << "latency_ps,in_clk_cycles,out_clk_cycles,count\n";
+      for(const auto& bin : m_latency)
+        hist << bin.first << "," << cycles(bin.first, m_in.period) << ","
+             << cycles(bin.first, m_out.period) << "," << bin.second << "\n";
+
+      std::ofstream thru(logs+"perf_throughput.csv");
+      thru << "port,window,acks,acks_per_clk\n";
+      for(size_t w = 0; w < m_in.windows.size(); ++w)
+        thru << "in," << w << "," << m_in.windows[w] << "," << (double)m_in.windows[w]/window_clks << "\n";
+      for(size_t w = 0; w < m_out.windows.size(); ++w)
+        thru << "out," << w << "," << m_out.windows[w] << "," << (double)m_out.windows[w]/window_clks << "\n";
+
+      UVM_INFO(get_name()+"::"+__func__, "Latency samples: "+std::to_string(samples)+
+        ", mismatched reads: "+std::to_string(m_mismatches)+", stall ratio in: "+std::to_string(stall_ratio(m_in))+", out: "+
+        std::to_string(stall_ratio(m_out))+", saved at: "+logs+"perf.json", uvm::UVM_LOW);
+    }
+
+
+protected:
+  // Per port clock counts, filled by the sampling threads.
+  struct port_stats {
+    sc_core::sc_time      period;
+    uint64_t              strobes = 0; // Clocks with CYC and STB
+    uint64_t              stalls  = 0; // Of those, held by STALL
+    uint64_t              clks    = 0; // Clocks into the current window
+    std::vector<uint32_t> windows;     // ACKs per window
+  };
+
+  // Written, not read yet: stream position past the write's last bit, ACK time
+  std::deque<std::pair<uint64_t, sc_core::sc_time>> m_inflight;
+  std::map<uint64_t, uint64_t> m_latency; // Latency (ps) -> count
+  uint64_t   m_in_pos;  // Predictor stream positions last seen
+  uint64_t   m_out_pos;
+  uint64_t   m_dropped;
+  uint64_t   m_mismatches;
+  port_stats m_in;
+  port_stats m_out;
+
+  void sample(wb4_bfm* vif, port_stats& port) {
+    sc_core::sc_time last;
+    while(true) {
+      sc_core::wait(vif->clk_i.posedge_event());
+      port.period = sc_core::sc_time_stamp() - last;
+      last        = sc_core::sc_time_stamp();
+      if(vif->rst_i.read())
+        continue;
+      if(port.clks++ % window_clks == 0)
+        port.windows.push_back(0);
+      if(vif->ack.read())
+        port.windows.back()++;
+      if(vif->cyc.read() && vif->stb.read()) {
+        port.strobes++;
+        if(vif->stall.read())
+          port.stalls++;
+      }
+    }
+  }
+
+  void write_port() { sample(in_vif, m_in); }
+  void read_port()  { sample(out_vif, m_out); }
+
+  // Sim time in ps, whatever the time resolution.
+  static uint64_t ps(const sc_core::sc_time& t) {
+    return t.value() / sc_core::sc_time(1, sc_core::SC_PS).value();
+  }
+
+  static double cycles(double lat_ps, const sc_core::sc_time& period) {
+    return (ps(period) == 0) ? 0.0 : lat_ps / (double)ps(period);
+  }
+
+  // Writes past the predictor's write position were rolled back (aborted).
+  void drop_rolled_back() {
+    while(!m_inflight.empty() && m_inflight.back().first > prd->in_position()) {
+      m_inflight.pop_back();
+      m_dropped++;
+    }
+    m_in_pos = std::min(m_in_pos, prd->in_position());
+  }
+
+  static double stall_ratio(const port_stats& port) {
+    return (port.strobes == 0) ? 0.0 : (double)port.stalls / port.strobes;
+  }
+
+  // Latency at the p-th fraction of the samples.
+  uint64_t percentile(uint64_t samples, double p) const {
+    uint64_t rank = (uint64_t)(p * (samples - 1)) + 1;
+    uint64_t seen = 0;
+    for(const auto& bin : m_latency) {
+      seen += bin.second;
+      if(seen >= rank)
+        return bin.first;
+    }
+    return 0;
+  }
+
+  std::string stats_json(uint64_t samples, double sum, const sc_core::sc_time& period) const {
+    std::ostringstream os;
+    if(samples == 0) {
+      os << "null";
+      return os.str();
+    }
+    os << "{\"min\": " << cycles(m_latency.begin()->first, period)
+       << ", \"mean\": " << cycles(sum / samples, period)
+       << ", \"p50\": " << cycles(percentile(samples, 0.50), period)
+       << ", \"p99\": " << cycles(percentile(samples, 0.99), period)
+       << ", \"max\": " << cycles(m_latency.rbegin()->first, period) << "}";
+    return os.str();
+  }
+
+  std::string windows_json(const port_stats& port) const {
+    std::ostringstream os;
+    os << "[";
+    for(size_t w = 0; w < port.windows.size(); ++w)
+      os << ((w == 0) ? "" : ", ") << (double)port.windows[w]/window_clks;
+    os << "]";
+    return os.str();
+  }
+};
+
+#endif
@@ -0,0 +1,226 @@
+/* 
+ 
+ Copyright (c) 2025, Jose R. Garcia (jg-fossh@protonmail.com)
+ All rights reserved.
+
+ 
+    Licensed under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in
+    compliance with the License.  You may obtain a copy of
+    the License at
+ 
+        http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in
+    writing, software distributed under the License is
+    distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+    CONDITIONS OF ANY KIND, either express or implied.  See
+    the License for the specific language governing
+    permissions and limitations under the License.
+
+--------------------------------------------------------------------------------
+File name      : timed_model.h
+Author         : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name   : Wishbone B4 FIFO Library
+Class(es) Name : timed_model
+Description    : Cycle level reference for the FIFO ACK and STALL timing, one
+                 clock domain per port. Shared by the sync and the dual clock
+                 FIFO benches.
+
+Additional Comments:
+  Samples CYC/STB/STALL/ACK of both ports on every rising edge of their
+  clocks and keeps the occupancy as each port sees it.
+  - Every accepted strobe must be acked exactly wr_ack_lat/rd_ack_lat clocks
+    later, a slower or missing ACK is a latency error.
+  - A write is readable rd_vis_lat read clocks after its edge, a read frees
+    its slot wr_vis_lat write clocks after its edge (0 = on the same clock).
+    STALL while the port is known to have room (writes) or words (reads) is
+    a throughput error, a strobe taken past full or empty is an overflow.
+  The latencies are the bench's, its tb_env sets all four from the uut
+  parameters. Across clock domains the visibility latencies are upper
+  bounds: the synchronizer depth plus the gray pointer register, the flag
+  logic and a clock of phase between the domains.
+  Meant for P_NB_RESP=0 and no read pipeline. Disabled unless tb_env
+  enables it.
+ 
+*/
+
+#ifndef TIMED_MODEL_H_
+#define TIMED_MODEL_H_
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include <systemc>
+#include <uvm>
+
+//--------------------------------------------------------------------------
+// Class : timed_model
+// Description :
+//--------------------------------------------------------------------------
+class timed_model : public uvm::uvm_component {
+public:
+  bool enabled;
+  int  depth;
+  int  wr_ack_lat;
+  int  rd_ack_lat;
+  int  wr_vis_lat;
+  int  rd_vis_lat;
+  int  errors;
+  wb4_bfm* in_vif;
+  wb4_bfm* out_vif;
+
+  SC_HAS_PROCESS(timed_model);
+  // Provide implementations of virtual methods such as get_type_name and create
+  UVM_COMPONENT_UTILS(timed_model);
+
+
+  timed_model(uvm::uvm_component_name name="timed_model")
+      : uvm::uvm_component(name), enabled(false), depth(128),
+        wr_ack_lat(1), rd_ack_lat(1), wr_vis_lat(0), rd_vis_lat(1),
+        errors(0), in_vif(nullptr), out_vif(nullptr),
+        m_writes(0), m_reads(0), m_writes_seen(0), m_reads_seen(0),
+        m_wr_cycle(0), m_rd_cycle(0), m_wr_stalls(0), m_rd_stalls(0),
+        m_wr_period(sc_core::SC_ZERO_TIME), m_rd_period(sc_core::SC_ZERO_TIME) {
+    SC_THREAD(write_port);
+    SC_THREAD(read_port);
+  }
+
+
+  virtual void report_phase(uvm::uvm_phase& phase) {
+    if(!enabled)
+      return;
+    if(!m_wr_ack_due.empty() || !m_rd_ack_due.empty())
+      fail("Strobes never acked, writes: "+std::to_string(m_wr_ack_due.size())+
+        ", reads: "+std::to_string(m_rd_ack_due.size()));
+    UVM_INFO(get_name()+"::"+__func__, "Writes: "+std::to_string(m_writes)+
+      ", stalled clocks: "+std::to_string(m_wr_stalls)+"/"+std::to_string(m_wr_cycle)+
+      ", reads: "+std::to_string(m_reads)+", stalled clocks: "+std::to_string(m_rd_stalls)+
+      "/"+std::to_string(m_rd_cycle)+", timing errors: "+std::to_string(errors), uvm::UVM_LOW);
+  }
+
+
+protected:
+  uint64_t m_writes;      // Accepted so far
+  uint64_t m_reads;
+  uint64_t m_writes_seen; // Readable for sure
+  uint64_t m_reads_seen;  // Slot free for sure
+  uint64_t m_wr_cycle;
+  uint64_t m_rd_cycle;
+  uint64_t m_wr_stalls;
+  uint64_t m_rd_stalls;
+  sc_core::sc_time m_wr_period;
+  sc_core::sc_time m_rd_period;
+  std::deque<sc_core::sc_time> m_wr_stamps; // Writes not readable for sure yet
+  std::deque<sc_core::sc_time> m_rd_stamps; // Reads not freed for sure yet
+  std::deque<uint64_t> m_wr_ack_due;
+  std::deque<uint64_t> m_rd_ack_due;
+
+  void fail(const std::string& msg) {
+    if(errors++ < 10)
+      UVM_ERROR(get_name(), msg);
+  }
+
+  // Checks one port edge, the accepts of both ports on the same edge are
+  // recorded first so each side sees the other's strobe of this clock.
+  void write_port() {
+    sc_core::sc_time last;
+    while(enabled) {
+      sc_core::wait(in_vif->clk_i.posedge_event());
+      sc_core::sc_time now = sc_core::sc_time_stamp();
+      m_wr_period = now - last;
+      last = now;
+      bool rst    = in_vif->rst_i.read();
+      bool stb    = in_vif->cyc.read() && in_vif->stb.read();
+      bool stall  = in_vif->stall.read();
+      bool ack    = in_vif->ack.read();
+      bool accept = !rst && stb && !stall;
+      if(accept) {
+        m_writes++;
+        m_wr_stamps.push_back(now);
+      }
+      sc_core::wait(sc_core::SC_ZERO_TIME);
+      if(rst)
+        continue;
+      m_wr_cycle++;
+
+      if(accept)
+        m_wr_ack_due.push_back(m_wr_cycle + wr_ack_lat);
+      check_ack("Write", ack, m_wr_cycle, m_wr_ack_due);
+
+      while(!m_rd_stamps.empty() && m_rd_stamps.front() + wr_vis_lat*m_wr_period <= now) {
+        m_rd_stamps.pop_front();
+        m_reads_seen++;
+      }
+      // Stored before this edge, against the reads of this edge or older.
+      uint64_t stored = m_writes - (accept ? 1 : 0);
+      if(stb && stall) {
+        m_wr_stalls++;
+        if((int64_t)(stored - m_reads_seen) < depth)
+          fail("Write stalled with "+std::to_string(stored - m_reads_seen)+" of "+
+            std::to_string(depth)+" words stored");
+      }
+      if(accept && (int64_t)(stored - m_reads) >= depth)
+        fail("Write taken while full");
+    }
+  }
+
+  void read_port() {
+    sc_core::sc_time last;
+    while(enabled) {
+      sc_core::wait(out_vif->clk_i.posedge_event());
+      sc_core::sc_time now = sc_core::sc_time_stamp();
+      m_rd_period = now - last;
+      last = now;
+      bool rst    = out_vif->rst_i.read();
+      bool stb    = out_vif->cyc.read() && out_vif->stb.read();
+      bool stall  = out_vif->stall.read();
+      bool ack    = out_vif->ack.read();
+      bool accept = !rst && stb && !stall;
+      if(accept) {
+        m_reads++;
+        m_rd_stamps.push_back(now);
+      }
+      sc_core::wait(sc_core::SC_ZERO_TIME);
+      if(rst)
+        continue;
+      m_rd_cycle++;
+
+      if(accept)
+        m_rd_ack_due.push_back(m_rd_cycle + rd_ack_lat);
+      check_ack("Read", ack, m_rd_cycle, m_rd_ack_due);
+
+      while(!m_wr_stamps.empty() && m_wr_stamps.front() + rd_vis_lat*m_rd_period <= now) {
+        m_wr_stamps.pop_front();
+        m_writes_seen++;
+      }
+      // Read before this edge, against the writes of this edge or older.
+      uint64_t taken = m_reads - (accept ? 1 : 0);
+      if(stb && stall) {
+        m_rd_stalls++;
+        if(m_writes_seen > taken)
+          fail("Read stalled with "+std::to_string(m_writes_seen - taken)+" words readable");
+      }
+      if(accept && m_writes <= taken)
+        fail("Read taken while empty");
+    }
+  }
+
+  void check_ack(const std::string& port, bool ack, uint64_t cycle, std::deque<uint64_t>& due) {
+    // A late ACK is counted once, the ACK that finally comes is its own.
+    if(!due.empty() && due.front() < cycle) {
+      fail(port+" ACK late, due "+std::to_string(cycle - due.front())+" clocks ago");
+      due.pop_front();
+      return;
+    }
+    if(!ack)
+      return;
+    if(due.empty() || due.front() != cycle)
+      fail(port+" ACK without a strobe due on this clock");
+    else
+      due.pop_front();
+  }
+};
+
+#endif
@@ -0,0 +1,197 @@
+/* 
+ 
+ Copyright (c) 2025, Jose R. Garcia (jg-fossh@protonmail.com)
+ All rights reserved.
+
+ 
+    Licensed under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in
+    compliance with the License.  You may obtain a copy of
+    the License at
+ 
+        http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in
+    writing, software distributed under the License is
+    distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+    CONDITIONS OF ANY KIND, either express or implied.  See
+    the License for the specific language governing
+    permissions and limitations under the License.
+
+--------------------------------------------------------------------------------
+File name      : trace_logger.h
+Author         : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name   : Wishbone B4 FIFO Library
+Class(es) Name : trace_logger
+Description    : Appends every monitored transaction to logs/trace.bin.
+
+Additional Comments:
+  One wb4_trace::record per write and read ACK, with the sim time, the
+  data, the port's clock domain and the strobe clocks STALL held since the
+  port's previous transaction. A strobe refused with ERR or RTY (P_NB_RESP)
+  gets a record of its own flagged FLAG_ERR or FLAG_RTY, with no data.
+  The records go through a buffered writer so the sim only pays a copy per
+  transaction. Off unless the test sets "trace", read the file with
+  tb/trace/wb4_trace (stats, diff, dump). Shared by the sync and the dual
+  clock FIFO benches.
+ 
+*/
+
+#ifndef TRACE_LOGGER_H_
+#define TRACE_LOGGER_H_
+
+#include <cstdint>
+#include <string>
+
+#include <systemc>
+#include <uvm>
+
+#include "../trace/wb4_trace.h"
+
+//--------------------------------------------------------------------------
+// Class : trace_logger
+// Description :
+//--------------------------------------------------------------------------
+class trace_logger : public uvm::uvm_component {
+public:
+  bool    enabled;
+  uint8_t in_domain;
+  uint8_t out_domain;
+  wb4_bfm* in_vif;
+  wb4_bfm* out_vif;
+  sc_core::sc_signal<bool>* in_err;
+  sc_core::sc_signal<bool>* in_rty;
+  sc_core::sc_signal<bool>* out_err;
+  sc_core::sc_signal<bool>* out_rty;
+  uvm::uvm_analysis_export<wb4_seq_item> in_ap;
+  uvm::uvm_analysis_export<wb4_seq_item> out_ap;
+
+    class in_subscriber : public uvm::uvm_subscriber<wb4_seq_item> {
+    public:
+        trace_logger* trc;
+
+        in_subscriber(const uvm::uvm_component_name& name, trace_logger* trc)
+            : uvm_subscriber<wb4_seq_item>(name), trc(trc) {}
+
+        void write(const wb4_seq_item& t) override {
+            trc->append(wb4_trace::PORT_IN, trc->in_domain, wb4_trace::FLAG_ACK, t.dat_o, trc->m_in_stalls);
+        }
+    };
+
+    class out_subscriber : public uvm::uvm_subscriber<wb4_seq_item> {
+    public:
+        trace_logger* trc;
+
+        out_subscriber(const uvm::uvm_component_name& name, trace_logger* trc)
+            : uvm_subscriber<wb4_seq_item>(name), trc(trc) {}
+
+        void write(const wb4_seq_item& t) override {
+            trc->append(wb4_trace::PORT_OUT, trc->out_domain, wb4_trace::FLAG_ACK, t.dat_i, trc->m_out_stalls);
+        }
+    };
+
+    in_subscriber  in_writer;
+    out_subscriber out_writer;
+
+  SC_HAS_PROCESS(trace_logger);
+  // Provide implementations of virtual methods such as get_type_name and create
+  UVM_COMPONENT_UTILS(trace_logger);
+
+
+    trace_logger(uvm::uvm_component_name name="trace_logger")
+        : uvm::uvm_component(name), enabled(false), in_domain(0), out_domain(0),
+          in_vif(nullptr), out_vif(nullptr),
+          in_err(nullptr), in_rty(nullptr), out_err(nullptr), out_rty(nullptr),
+          in_ap("in_ap"),
+          out_ap("out_ap"),
+          in_writer("in_writer", this),
+          out_writer("out_writer", this),
+          m_in_stalls(0), m_out_stalls(0), m_records(0) {
+      SC_THREAD(write_port);
+      SC_THREAD(read_port);
+    }
+
+
+    virtual void build_phase(uvm::uvm_phase& phase) {
+      uvm::uvm_component::build_phase(phase);
+      if(! uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_err", in_err) ||
+         ! uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_rty", in_rty) ||
+         ! uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_err", out_err) ||
+         ! uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_rty", out_rty))
+        UVM_FATAL("NOSIG", "ERR/RTY signals not in the config_db: " + get_full_name());
+    }
+
+
+    virtual void connect_phase(uvm::uvm_phase& phase) {
+        in_ap.connect(in_writer.analysis_export);
+        out_ap.connect(out_writer.analysis_export);
+    }
+
+
+    virtual void start_of_simulation_phase(uvm::uvm_phase& phase) {
+      if(!enabled)
+        return;
+      std::string uvmtest_name;
+      if(!uvm::uvm_config_db<std::string>::get(this, "*", "uvmtest_name", uvmtest_name))
+        UVM_FATAL("NOTST", "Test name not in the config_db: " + get_full_name() + ".uvmtest_name");
+      m_path = uvmtest_name+"/logs/trace.bin";
+      Verilated::mkdir((uvmtest_name+"/").c_str());
+      Verilated::mkdir((uvmtest_name+"/logs/").c_str());
+      if(!m_file.open(m_path))
+        UVM_ERROR(get_name(), "Can't open the trace file: "+m_path);
+    }
+
+
+    virtual void report_phase(uvm::uvm_phase& phase) {
+      if(!m_file.is_open())
+        return;
+      if(!m_file.close())
+        UVM_ERROR(get_name(), "Short write, the trace file is incomplete: "+m_path);
+      UVM_INFO(get_name()+"::"+__func__, "Transactions traced: "+std::to_string(m_records)+
+        ", saved at: "+m_path, uvm::UVM_LOW);
+    }
+
+
+protected:
+  uint32_t m_in_stalls;  // Strobe clocks held by STALL since the last record
+  uint32_t m_out_stalls;
+  uint64_t m_records;
+  std::string       m_path;
+  wb4_trace::writer m_file;
+
+  void append(uint8_t port, uint8_t domain, uint8_t flags, uint64_t data, uint32_t& stalls) {
+    wb4_trace::record rec;
+    rec.time_ps    = sc_core::sc_time_stamp().value() / sc_core::sc_time(1, sc_core::SC_PS).value();
+    rec.data       = data;
+    rec.stall_clks = stalls;
+    rec.port       = port;
+    rec.clk_domain = domain;
+    rec.flags      = flags;
+    rec.reserved   = 0;
+    m_file.append(rec);
+    m_records++;
+    stalls = 0;
+  }
+
+  // Counts the STALL clocks and records the strobes the FIFO refused, ERR
+  // and RTY are one clock per refused strobe like ACK.
+  void watch_port(wb4_bfm* vif, sc_core::sc_signal<bool>* err, sc_core::sc_signal<bool>* rty,
+                  uint8_t port, const uint8_t& domain, uint32_t& stalls) {
+    while(enabled) {
+      sc_core::wait(vif->clk_i.posedge_event());
+      if(vif->rst_i.read())
+        continue;
+      if(vif->cyc.read() && vif->stb.read() && vif->stall.read())
+        stalls++;
+      if(err->read())
+        append(port, domain, wb4_trace::FLAG_ERR, 0, stalls);
+      if(rty->read())
+        append(port, domain, wb4_trace::FLAG_RTY, 0, stalls);
+    }
+  }
+
+  void write_port() { watch_port(in_vif, in_err, in_rty, wb4_trace::PORT_IN, in_domain, m_in_stalls); }
+  void read_port()  { watch_port(out_vif, out_err, out_rty, wb4_trace::PORT_OUT, out_domain, m_out_stalls); }
+};
+
+#endif
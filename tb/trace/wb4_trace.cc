@@ -0,0 +1,205 @@
+/* 
+ 
+ Copyright (c) 2025, Jose R. Garcia (jg-fossh@protonmail.com)
+ All rights reserved.
+
+ 
+    Licensed under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in
+    compliance with the License.  You may obtain a copy of
+    the License at
+ 
+        http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in
+    writing, software distributed under the License is
+    distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+    CONDITIONS OF ANY KIND, either express or implied.  See
+    the License for the specific language governing
+    permissions and limitations under the License.
+
+--------------------------------------------------------------------------------
+File name      : wb4_trace.cc
+Author         : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name   : Wishbone B4 FIFO Library
+Class(es) Name : main
+Description    : wb4_trace CLI, statistics and run to run diffs of the binary
+                 transaction traces the test benches write.
+
+Additional Comments:
+  wb4_trace stats <trace.bin>          Per port counts, rates, stalls and
+                                       ERR/RTY refusals, plus the write to
+                                       read latency.
+  wb4_trace diff  <a.bin> <b.bin>      First data mismatch per port and the
+                                       timing drift, exits 1 if the data differ.
+  wb4_trace dump  <trace.bin> [count]  Prints the records as text.
+  Build: g++ -std=c++17 -O2 -o wb4_trace wb4_trace.cc
+ 
+*/
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "wb4_trace.h"
+
+using wb4_trace::record;
+
+static const char* PORT_NAME[2] = {"in", "out"};
+
+
+//--------------------------------------------------------------------------------
+// Per port view of a trace
+//--------------------------------------------------------------------------------
+static std::vector<const record*> port_records(const wb4_trace::reader& trace, uint8_t port) {
+  std::vector<const record*> recs;
+  for(const record* rec = trace.begin(); rec != trace.end(); ++rec)
+    if(rec->port == port)
+      recs.push_back(rec);
+  return recs;
+}
+
+
+static int stats(const wb4_trace::reader& trace) {
+  std::printf("records: %zu\n", trace.size());
+  for(uint8_t port = wb4_trace::PORT_IN; port <= wb4_trace::PORT_OUT; ++port) {
+    uint64_t n = 0, stalls = 0, errs = 0, rtys = 0, first = 0, last = 0;
+    for(const record* rec = trace.begin(); rec != trace.end(); ++rec) {
+      if(rec->port != port)
+        continue;
+      stalls += rec->stall_clks;
+      errs   += (rec->flags & wb4_trace::FLAG_ERR) ? 1 : 0;
+      rtys   += (rec->flags & wb4_trace::FLAG_RTY) ? 1 : 0;
+      if(!(rec->flags & wb4_trace::FLAG_ACK))
+        continue;
+      if(n++ == 0)
+        first = rec->time_ps;
+      last    = rec->time_ps;
+    }
+    double span_us = (last - first) / 1e6;
+    std::printf("%-3s  transactions: %" PRIu64 ", span: %.3f us, rate: %.3f /us, "
+                "stall clocks: %" PRIu64 ", err: %" PRIu64 ", rty: %" PRIu64 "\n",
+                PORT_NAME[port], n, span_us, (span_us > 0.0) ? (n - 1) / span_us : 0.0,
+                stalls, errs, rtys);
+  }
+
+  // Writes matched in order with the reads returning their data, the words
+  // a read skips past are counted as dropped. Refused strobes carry no data.
+  std::deque<const record*> inflight;
+  uint64_t matched = 0, dropped = 0, lat_min = UINT64_MAX, lat_max = 0;
+  double   lat_sum = 0.0;
+  for(const record* rec = trace.begin(); rec != trace.end(); ++rec) {
+    if(!(rec->flags & wb4_trace::FLAG_ACK))
+      continue;
+    if(rec->port == wb4_trace::PORT_IN) {
+      inflight.push_back(rec);
+      continue;
+    }
+    auto it = std::find_if(inflight.begin(), inflight.end(),
+                           [rec](const record* w) { return w->data == rec->data; });
+    if(it == inflight.end())
+      continue;
+    uint64_t lat = rec->time_ps - (*it)->time_ps;
+    lat_min  = std::min(lat_min, lat);
+    lat_max  = std::max(lat_max, lat);
+    lat_sum += lat;
+    dropped += it - inflight.begin();
+    matched++;
+    inflight.erase(inflight.begin(), it+1);
+  }
+  if(matched == 0)
+    std::printf("latency: no write matched a read\n");
+  else
+    std::printf("latency: matched %" PRIu64 ", dropped %" PRIu64 ", unread %zu, "
+                "min %" PRIu64 " ps, mean %.1f ps, max %" PRIu64 " ps\n",
+                matched, dropped, inflight.size(), lat_min, lat_sum / matched, lat_max);
+  return 0;
+}
+
+
+static int diff(const wb4_trace::reader& a, const wb4_trace::reader& b) {
+  bool same = true;
+  for(uint8_t port = wb4_trace::PORT_IN; port <= wb4_trace::PORT_OUT; ++port) {
+    std::vector<const record*> ra = port_records(a, port);
+    std::vector<const record*> rb = port_records(b, port);
+    size_t common = std::min(ra.size(), rb.size());
+    size_t first_mismatch = common;
+    int64_t drift_max = 0;
+    double  drift_sum = 0.0;
+    uint64_t stalls_a = 0, stalls_b = 0;
+    for(size_t i = 0; i < common; ++i) {
+      if(first_mismatch == common && ra[i]->data != rb[i]->data)
+        first_mismatch = i;
+      int64_t drift = (int64_t)(rb[i]->time_ps - ra[i]->time_ps);
+      drift_max  = (std::llabs(drift) > std::llabs(drift_max)) ? drift : drift_max;
+      drift_sum += drift;
+    }
+    for(const record* rec : ra) stalls_a += rec->stall_clks;
+    for(const record* rec : rb) stalls_b += rec->stall_clks;
+
+    std::printf("%-3s  transactions: %zu vs %zu, stall clocks: %" PRIu64 " vs %" PRIu64
+                ", time drift: mean %.1f ps, worst %" PRId64 " ps\n",
+                PORT_NAME[port], ra.size(), rb.size(), stalls_a, stalls_b,
+                (common > 0) ? drift_sum / common : 0.0, drift_max);
+    if(first_mismatch != common) {
+      std::printf("     first data mismatch at transaction %zu: 0x%" PRIx64 " vs 0x%" PRIx64 "\n",
+                  first_mismatch, ra[first_mismatch]->data, rb[first_mismatch]->data);
+      same = false;
+    }
+    if(ra.size() != rb.size())
+      same = false;
+  }
+  std::printf("%s\n", same ? "data identical" : "data differ");
+  return same ? 0 : 1;
+}
+
+
+static int dump(const wb4_trace::reader& trace, size_t count) {
+  std::printf("time_ps,port,clk_domain,data,stall_clks,flags\n");
+  size_t n = 0;
+  for(const record* rec = trace.begin(); rec != trace.end() && n < count; ++rec, ++n)
+    std::printf("%" PRIu64 ",%s,%u,0x%" PRIx64 ",%u,%u\n", rec->time_ps,
+                PORT_NAME[rec->port & 1], rec->clk_domain, rec->data, rec->stall_clks, rec->flags);
+  return 0;
+}
+
+
+static int usage() {
+  std::fprintf(stderr, "usage: wb4_trace stats <trace.bin>\n"
+                       "       wb4_trace diff  <a.bin> <b.bin>\n"
+                       "       wb4_trace dump  <trace.bin> [count]\n");
+  return 2;
+}
+
+
+int main(int argc, char* argv[]) {
+  if(argc < 3)
+    return usage();
+  std::string cmd = argv[1];
+
+  wb4_trace::reader a;
+  std::string err = a.open(argv[2]);
+  if(!err.empty()) {
+    std::fprintf(stderr, "wb4_trace: %s\n", err.c_str());
+    return 2;
+  }
+
+  if(cmd == "stats")
+    return stats(a);
+  if(cmd == "dump")
+    return dump(a, (argc > 3) ? std::strtoull(argv[3], nullptr, 0) : SIZE_MAX);
+  if(cmd == "diff" && argc > 3) {
+    wb4_trace::reader b;
+    err = b.open(argv[3]);
+    if(!err.empty()) {
+      std::fprintf(stderr, "wb4_trace: %s\n", err.c_str());
+      return 2;
+    }
+    return diff(a, b);
+  }
+  return usage();
+}
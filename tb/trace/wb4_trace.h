@@ -0,0 +1,196 @@
+/* 
+ 
+ Copyright (c) 2025, Jose R. Garcia (jg-fossh@protonmail.com)
+ All rights reserved.
+
+ 
+    Licensed under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in
+    compliance with the License.  You may obtain a copy of
+    the License at
+ 
+        http://www.apache.org/licenses/LICENSE-2.0
+ 
+    Unless required by applicable law or agreed to in
+    writing, software distributed under the License is
+    distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+    CONDITIONS OF ANY KIND, either express or implied.  See
+    the License for the specific language governing
+    permissions and limitations under the License.
+
+--------------------------------------------------------------------------------
+File name      : wb4_trace.h
+Author         : Jose R Garcia (jg-fossh@protonmail.com)
+Project Name   : Wishbone B4 FIFO Library
+Class(es) Name : wb4_trace::record; wb4_trace::writer; wb4_trace::reader
+Description    : Binary transaction trace, file format, buffered writer and
+                 mmap reader.
+
+Additional Comments:
+  The file is a 16 byte header (magic "WB4TRACE", version, record size)
+  followed by fixed size little endian records appended in sim time order,
+  one per monitored transaction. No UVM or SystemC in here so the test
+  benches and the wb4_trace CLI share it.
+ 
+*/
+
+#ifndef WB4_TRACE_H_
+#define WB4_TRACE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wb4_trace {
+
+  static const char     MAGIC[8] = {'W','B','4','T','R','A','C','E'};
+  static const uint32_t VERSION  = 1;
+
+  enum port_id : uint8_t { PORT_IN = 0, PORT_OUT = 1 };
+  enum flag_bits : uint8_t { FLAG_ACK = 1, FLAG_ERR = 2, FLAG_RTY = 4 };
+
+  struct file_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+  };
+
+  struct record {
+    uint64_t time_ps;    // Sim time of the ACK, ERR or RTY
+    uint64_t data;       // Written or read data, 0 on ERR/RTY
+    uint32_t stall_clks; // Strobe clocks held by STALL since the port's previous record
+    uint8_t  port;       // port_id
+    uint8_t  clk_domain; // Clock the port runs on, 0 when both share one
+    uint8_t  flags;      // flag_bits
+    uint8_t  reserved;
+  };
+
+  static_assert(sizeof(file_header) == 16, "trace header is 16 bytes");
+  static_assert(sizeof(record) == 24, "trace records are 24 bytes");
+
+  //--------------------------------------------------------------------------
+  // Class : writer
+  // Description : Collects records in a fixed buffer, written out with one
+  //               fwrite per buffer full and on close(). A short write is
+  //               latched, close() returns false once one happened.
+  //--------------------------------------------------------------------------
+  class writer {
+  public:
+    explicit writer(size_t buffer_records = 4096) : m_file(nullptr), m_fill(0), m_ok(true) {
+      m_buffer.resize(buffer_records);
+    }
+    ~writer() { close(); }
+
+    bool open(const std::string& path) {
+      close();
+      m_file = std::fopen(path.c_str(), "wb");
+      if(m_file == nullptr)
+        return false;
+      file_header hdr;
+      std::memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+      hdr.version     = VERSION;
+      hdr.record_size = sizeof(record);
+      m_ok = std::fwrite(&hdr, sizeof(hdr), 1, m_file) == 1;
+      return m_ok;
+    }
+
+    bool is_open() const { return m_file != nullptr; }
+
+    void append(const record& rec) {
+      if(m_file == nullptr)
+        return;
+      m_buffer[m_fill++] = rec;
+      if(m_fill == m_buffer.size())
+        flush();
+    }
+
+    bool flush() {
+      if(m_file == nullptr || m_fill == 0)
+        return m_ok;
+      if(std::fwrite(m_buffer.data(), sizeof(record), m_fill, m_file) != m_fill)
+        m_ok = false;
+      m_fill = 0;
+      return m_ok;
+    }
+
+    bool close() {
+      if(m_file == nullptr)
+        return m_ok;
+      flush();
+      if(std::fclose(m_file) != 0)
+        m_ok = false;
+      m_file = nullptr;
+      return m_ok;
+    }
+
+  private:
+    std::FILE*          m_file;
+    std::vector<record> m_buffer;
+    size_t              m_fill;
+    bool                m_ok;
+  };
+
+  //--------------------------------------------------------------------------
+  // Class : reader
+  // Description : Maps a trace file read only, the records are used in place.
+  //--------------------------------------------------------------------------
+  class reader {
+  public:
+    reader() : m_base(nullptr), m_length(0) {}
+    ~reader() { close(); }
+
+    // Returns an empty string or what is wrong with the file.
+    std::string open(const std::string& path) {
+      close();
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if(fd < 0)
+        return "can't open "+path;
+      struct stat st;
+      if(::fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(file_header)) {
+        ::close(fd);
+        return path+" is not a trace file";
+      }
+      m_length = st.st_size;
+      void* base = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if(base == MAP_FAILED) {
+        m_length = 0;
+        return "can't map "+path;
+      }
+      m_base = static_cast<const uint8_t*>(base);
+      const file_header* hdr = reinterpret_cast<const file_header*>(m_base);
+      if(std::memcmp(hdr->magic, MAGIC, sizeof(MAGIC)) != 0 || hdr->version != VERSION ||
+         hdr->record_size != sizeof(record)) {
+        close();
+        return path+" is not a version "+std::to_string(VERSION)+" trace file";
+      }
+      return "";
+    }
+
+    void close() {
+      if(m_base != nullptr)
+        ::munmap(const_cast<uint8_t*>(m_base), m_length);
+      m_base   = nullptr;
+      m_length = 0;
+    }
+
+    // A record cut short by a killed sim is left out.
+    size_t        size()  const { return (m_base == nullptr) ? 0 : (m_length - sizeof(file_header)) / sizeof(record); }
+    const record* begin() const { return (m_base == nullptr) ? nullptr : reinterpret_cast<const record*>(m_base + sizeof(file_header)); }
+    const record* end()   const { return begin() + size(); }
+
+  private:
+    const uint8_t* m_base;
+    size_t         m_length;
+  };
+
+} // namespace wb4_trace
+
+#endif
@@ -26,12 +26,32 @@ Class(es) Name : predictor
 Description    : Creates a non-time consuming FIFO as a 'golden' reference.
 
 Additional Comments:
+  Packet mode: with packet_mode set and cut_through clear (store-and-forward)
+  the written words are held in a pending frame until the test calls
+  end_of_frame(), abort_frame() drops them. With cut_through set every word
+  is readable right away and an aborted frame is still read out, flagged.
+  Non-blocking mode: with nb_resp set (1=RTY, 2=ERR, the uut P_NB_RESP) a
+  write beyond depth or a read from an empty FIFO is expected back with that
+  response instead of an ACK. The expected refusals are counted and checked
+  against the RTY/ERR the test saw on each port (refused_in()/refused_out()).
+  The model is a ring of stored words allocated once by configure() with the
+  uut P_DEPTH slots, a word lands in the same slot as in the uut memory. The
+  pending frame is the tail of the ring past m_commit, committing or
+  dropping it moves that pointer.
+  Width conversion: a stored word is as wide as the wider port and the data
+  is a bit stream through it, least significant bits first. A write appends
+  its bits to the word at m_wr, a read takes its bits from the word at m_rd,
+  so 1 to N, N to 1 and the gearbox widths are all modeled the same way.
  
 */
 
 #ifndef PREDICTOR_H_
 #define PREDICTOR_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include <systemc>
 #include <uvm>
 
@@ -42,6 +62,16 @@ Additional Comments:
 class predictor : public uvm::uvm_component {
 public:
   int depth;
+  bool packet_mode;
+  bool cut_through;
+  int frames_committed;
+  int frames_aborted;
+  int words_dropped;
+  int nb_resp;
+  int in_refusals;
+  int out_refusals;
+  int in_refusals_seen;
+  int out_refusals_seen;
   uvm::uvm_analysis_export<wb4_seq_item> in_ap;
   uvm::uvm_analysis_export<wb4_seq_item> out_ap;
 
@@ -56,9 +86,7 @@ public:
             : uvm_subscriber<wb4_seq_item>(name), prd(prd) {}
 
         void write(const wb4_seq_item& t) override {
-            wb4_seq_item* t_clone = new wb4_seq_item();
-            t_clone->do_copy(t);
-            prd->write_in(t_clone);
+            prd->write_in(t);
         }
     };
 
@@ -70,9 +98,7 @@ public:
             : uvm_subscriber<wb4_seq_item>(name), prd(prd) {}
             
         void write(const wb4_seq_item& t) override {
-            wb4_seq_item* t_clone = new wb4_seq_item();
-            t_clone->do_copy(t);
-            prd->write_out(t_clone);
+            prd->write_out(t);
         }
     };
 
@@ -85,10 +111,32 @@ public:
 
     predictor(uvm::uvm_component_name name="predictor", int depth=128)
         : uvm::uvm_component(name), depth(depth),
+          packet_mode(false), cut_through(false),
+          frames_committed(0), frames_aborted(0), words_dropped(0),
+          nb_resp(0), in_refusals(0), out_refusals(0),
+          in_refusals_seen(0), out_refusals_seen(0),
           in_ap("in_ap"),
           out_ap("out_ap"),
           in_writer("in_writer", this),
-          out_writer("out_writer", this) {}
+          out_writer("out_writer", this) {
+      configure(depth, 64, 64);
+    }
+
+    // Sizes the model to the uut, called from tb_env::build_phase.
+    void configure(int uut_depth, int data_i_width, int data_o_width) {
+      depth        = uut_depth;
+      m_in_width   = data_i_width;
+      m_out_width  = data_o_width;
+      m_word_width = std::max(data_i_width, data_o_width);
+      m_in_mask    = bit_mask(data_i_width);
+      m_out_mask   = bit_mask(data_o_width);
+      m_ring.assign(uut_depth, 0);
+      m_rd       = 0;
+      m_commit   = 0;
+      m_wr       = 0;
+      m_in_bits  = 0;
+      m_out_bits = 0;
+    }
 
 
     virtual void connect_phase(uvm::uvm_phase& phase) {
@@ -96,29 +144,124 @@ public:
         out_ap.connect(out_writer.analysis_export);
     }
 
-    void write_in(wb4_seq_item* trans) {
-      wb4_seq_item* t_clone = new wb4_seq_item();
-      t_clone->do_copy(*static_cast<const wb4_seq_item*>(trans));
-      if(m_fifo.size() < depth) { 
-        m_fifo.push_front(t_clone->dat_o); // Data in to the DUT in data out of the UVC
-        this->in_to_sb_ap.write(*static_cast<const wb4_seq_item*>(t_clone)); // Dereference the pointer
+    void write_in(const wb4_seq_item& trans) {
+      if(m_wr - m_rd < (uint64_t)depth) { 
+        push_bits(trans.dat_o & m_in_mask, m_in_width); // Data in to the DUT in data out of the UVC
+        if(!packet_mode || cut_through)
+          m_commit = m_wr; // Held until the frame is committed otherwise
+        this->in_to_sb_ap.write(trans); // Written data is expected back as is
+      }
+      else if(nb_resp != 0) {
+        in_refusals++; // Terminated with RTY/ERR, nothing stored
       };
     }
 
-    void write_out(wb4_seq_item* trans) {
-      wb4_seq_item* t_clone = new wb4_seq_item();
-      t_clone->do_copy(*static_cast<const wb4_seq_item*>(trans));
-      if(!m_fifo.empty()) { 
-        t_clone->dat_i = m_fifo.back(); // Data out of the DUT in data into the UVC
-        m_fifo.pop_back(); 
-        this->out_to_sb_ap.write(*static_cast<const wb4_seq_item*>(t_clone)); // Dereference the pointer
+    // The frame written so far is committed, it becomes readable.
+    void end_of_frame() {
+      m_commit = m_wr;
+      frames_committed++;
+    }
+
+    // The frame written so far is aborted. Store-and-forward drops it,
+    // cut-through already let it through (the DUT flags it with abort).
+    void abort_frame() {
+      words_dropped += m_wr - m_commit;
+      m_wr = m_commit;
+      frames_aborted++;
+    }
+
+    virtual void report_phase(uvm::uvm_phase& phase) {
+      if(packet_mode)
+        UVM_INFO(get_name()+"::"+__func__, "Frames committed: "+std::to_string(frames_committed)+
+          ", aborted: "+std::to_string(frames_aborted)+", words dropped: "+std::to_string(words_dropped)+
+          ", words pending: "+std::to_string(m_wr - m_commit), uvm::UVM_LOW);
+      if(nb_resp != 0) {
+        std::string resp = (nb_resp == 1) ? "RTY" : "ERR";
+        UVM_INFO(get_name()+"::"+__func__, resp+" expected on writes: "+std::to_string(in_refusals)+
+          ", seen: "+std::to_string(in_refusals_seen)+", on reads: "+std::to_string(out_refusals)+
+          ", seen: "+std::to_string(out_refusals_seen), uvm::UVM_LOW);
+        if(in_refusals != in_refusals_seen || out_refusals != out_refusals_seen)
+          UVM_ERROR(get_name()+"::"+__func__, "Refused strobes don't match the "+resp+" responses");
+      }
+    }
+
+    void write_out(const wb4_seq_item& trans) {
+      if((m_commit - m_rd)*m_word_width - m_out_bits >= (uint64_t)m_out_width) { 
+        m_expected.do_copy(trans);
+        m_expected.dat_i = pop_bits(m_out_width); // Data out of the DUT in data into the UVC
+        this->out_to_sb_ap.write(m_expected); // The scoreboard keeps its own copy
+      }
+      else if(nb_resp != 0) {
+        out_refusals++; // Terminated with RTY/ERR, no data
       };
     }
 
+    // A RTY/ERR seen on the write or the read port.
+    void refused_in()  { in_refusals_seen++; }
+    void refused_out() { out_refusals_seen++; }
+
+
+    // Stream positions, bits written and bits read so far, see perf_analysis.
+    uint64_t in_position()  const { return m_wr*m_word_width + m_in_bits; }
+    uint64_t out_position() const { return m_rd*m_word_width + m_out_bits; }
+
+    // The expectation built for the last read.
+    const wb4_seq_item& expected() const { return m_expected; }
+
 
 protected:
-  //std::queue<wb4_seq_item*> m_fifo[127];
-  std::deque<uint64_t> m_fifo;
+  // Monitor items are taken by reference, the read side expectation is
+  // rebuilt in place.
+  wb4_seq_item m_expected;
+  std::vector<uint64_t> m_ring;
+  uint64_t m_rd;     // Free running, m_commit-m_rd words readable
+  uint64_t m_commit; // Uncommitted frame from here to m_wr, store-and-forward only
+  uint64_t m_wr;
+  uint64_t m_in_mask;
+  uint64_t m_out_mask;
+  int m_in_width;
+  int m_out_width;
+  int m_word_width; // Stored word, the wider port
+  int m_in_bits;    // Bits written into the word at m_wr
+  int m_out_bits;   // Bits read from the word at m_rd
+
+  static uint64_t bit_mask(int n) {
+    return (n >= 64) ? ~0ULL : ((1ULL << n) - 1);
+  }
+
+  // Appends n bits to the stream, a word is stored once it is whole.
+  void push_bits(uint64_t data, int n) {
+    while(n > 0) {
+      int take = std::min(n, m_word_width - m_in_bits);
+      uint64_t lanes = bit_mask(take) << m_in_bits;
+      uint64_t& word = m_ring[m_wr % depth];
+      word = (word & ~lanes) | ((data << m_in_bits) & lanes);
+      data = (take >= 64) ? 0 : (data >> take);
+      n         -= take;
+      m_in_bits += take;
+      if(m_in_bits == m_word_width) {
+        m_in_bits = 0;
+        m_wr++;
+      }
+    }
+  }
+
+  // Takes n bits off the stream, a word is freed once all of it was read.
+  uint64_t pop_bits(int n) {
+    uint64_t data = 0;
+    int      got  = 0;
+    while(got < n) {
+      int take = std::min(n - got, m_word_width - m_out_bits);
+      data |= ((m_ring[m_rd % depth] >> m_out_bits) & bit_mask(take)) << got;
+      got        += take;
+      m_out_bits += take;
+      if(m_out_bits == m_word_width) {
+        m_out_bits = 0;
+        m_rd++;
+      }
+    }
+    return data;
+  }
 };
 
 #endif
@@ -53,6 +53,39 @@ Additional Comments:
 using namespace sc_core;
 using namespace sc_dt;
 
+// uut parameters the predictor and the timed model are set from, the
+// Makefile passes the -G overrides down. The defaults match the RTL.
+#ifndef UUT_P_DEPTH
+#define UUT_P_DEPTH 128
+#endif
+#ifndef UUT_P_DATA_I_MSB
+#define UUT_P_DATA_I_MSB 7
+#endif
+#ifndef UUT_P_DATA_O_MSB
+#define UUT_P_DATA_O_MSB UUT_P_DATA_I_MSB
+#endif
+#ifndef UUT_P_USE_BRAM
+#define UUT_P_USE_BRAM 1
+#endif
+#ifndef UUT_P_NB_RESP
+#define UUT_P_NB_RESP 0
+#endif
+#ifndef UUT_P_CUT_THROUGH
+#define UUT_P_CUT_THROUGH 0
+#endif
+#ifndef UUT_P_WR_SYNC_DEPTH
+#define UUT_P_WR_SYNC_DEPTH 2
+#endif
+#ifndef UUT_P_RD_SYNC_DEPTH
+#define UUT_P_RD_SYNC_DEPTH 2
+#endif
+#ifndef UUT_P_CLK_MODE
+#define UUT_P_CLK_MODE 0
+#endif
+#ifndef UUT_P_RD_PIPE_STAGES
+#define UUT_P_RD_PIPE_STAGES 0
+#endif
+
 
 //--------------------------------------------------------------------------------
 // Main function for the SystemC simulation. (The Top of the simulation)
@@ -111,6 +144,33 @@ int sc_main(int argc, char* argv[]) {
   sc_clock fast_clk("fast_clk", 5, SC_NS, 0.5, 3, SC_NS, true);
   sc_clock slow_clk("slow_clk", 10, SC_NS, 0.5, 3, SC_NS, true);
   
+  // Fill level side band, the thresholds are only used with P_PROG_THRESH=1.
+  sc_signal<uint32_t> in_afull_thresh("in_afull_thresh");
+  sc_signal<bool>     in_almost_full("in_almost_full");
+  sc_signal<uint32_t> in_level("in_level");
+  sc_signal<uint32_t> out_aempty_thresh("out_aempty_thresh");
+  sc_signal<bool>     out_almost_empty("out_almost_empty");
+  sc_signal<uint32_t> out_level("out_level");
+  // Packet side band, only used when the uut is built with P_PACKET=1.
+  sc_signal<bool>     in_eop("in_eop");
+  sc_signal<bool>     in_abort("in_abort");
+  sc_signal<bool>     out_eop("out_eop");
+  sc_signal<bool>     out_abort("out_abort");
+  // Non-blocking responses, only used when the uut is built with P_NB_RESP!=0.
+  sc_signal<bool>     in_err("in_err");
+  sc_signal<bool>     out_err("out_err");
+  sc_signal<bool>     in_rty("in_rty");
+  sc_signal<bool>     out_rty("out_rty");
+  // Statistics CSR port, idle unless a test drives it (P_STATS=1).
+  sc_signal<bool>     csr_cyc("csr_cyc");
+  sc_signal<bool>     csr_stb("csr_stb");
+  sc_signal<bool>     csr_we("csr_we");
+  sc_signal<uint32_t> csr_adr("csr_adr");
+  sc_signal<uint32_t> csr_dat_o("csr_dat_o");
+  sc_signal<bool>     csr_ack("csr_ack");
+  sc_signal<uint32_t> csr_dat_i("csr_dat_i");
+  sc_signal<bool>     csr_stall("csr_stall");
+
   //Connect the Agents to the clock and reset signals.
   rst_vif->clk_i(slow_clk);
   //
@@ -128,6 +188,13 @@ int sc_main(int argc, char* argv[]) {
   uut->o_wb4_in_sack  (wb4_mst_in_if->ack  );   // WB acknowledge
   uut->i_wb4_in_sdata (wb4_mst_in_if->dat_o);   // WB acknowledge
   uut->o_wb4_in_sstall(wb4_mst_in_if->stall);   // WB acknowledge
+  uut->o_wb4_in_serr  (in_err              );   // Written while full
+  uut->o_wb4_in_srty  (in_rty              );   // Written while full
+  uut->i_wb4_in_afull_thresh(in_afull_thresh);   // Almost full threshold
+  uut->o_wb4_in_almost_full (in_almost_full );   // Almost full
+  uut->o_wb4_in_level       (in_level       );   // Write side fill level
+  uut->i_wb4_in_seop        (in_eop         );   // End of packet
+  uut->i_wb4_in_sabort      (in_abort       );   // Drop the packet
   // Control & Status Wishbone 4 Slave Interface
   uut->i_wb4_out_sclk  (slow_clk             );   // WB cycle
   uut->i_wb4_out_srst  (rst_vif->rst_o       );   // WB strobe
@@ -136,12 +203,60 @@ int sc_main(int argc, char* argv[]) {
   uut->o_wb4_out_sack  (wb4_mst_out_if->ack  );   // WB acknowledge
   uut->o_wb4_out_sdata (wb4_mst_out_if->dat_i);   // WB acknowledge
   uut->o_wb4_out_sstall(wb4_mst_out_if->stall);   // WB acknowledge
+  uut->i_wb4_out_aempty_thresh(out_aempty_thresh);   // Almost empty threshold
+  uut->o_wb4_out_almost_empty (out_almost_empty );   // Almost empty
+  uut->o_wb4_out_level        (out_level        );   // Read side fill level
+  uut->o_wb4_out_seop         (out_eop          );   // End of packet
+  uut->o_wb4_out_sabort       (out_abort        );   // Aborted packet
+  uut->o_wb4_out_serr         (out_err          );   // Read while empty
+  uut->o_wb4_out_srty         (out_rty          );   // Read while empty
+  // Statistics CSR Interface
+  uut->i_wb4_csr_scyc  (csr_cyc  );   // Cycle
+  uut->i_wb4_csr_sstb  (csr_stb  );   // Strobe
+  uut->i_wb4_csr_swe   (csr_we   );   // Write enable
+  uut->i_wb4_csr_sadr  (csr_adr  );   // Register
+  uut->i_wb4_csr_sdata (csr_dat_o);   // Write data
+  uut->o_wb4_csr_sack  (csr_ack  );   // Acknowledge
+  uut->o_wb4_csr_sdata (csr_dat_i);   // Read data
+  uut->o_wb4_csr_sstall(csr_stall);   // Stall
 
   // Add interface to configuration database.
   uvm::uvm_config_db<reset_generator_if*>::set(uvm::uvm_root::get(), "*", "rst_vif", rst_vif);
   uvm::uvm_config_db<wb4_bfm*>::set(uvm::uvm_root::get(), "*", "wb4_mst_in_if", wb4_mst_in_if);
   uvm::uvm_config_db<wb4_bfm*>::set(uvm::uvm_root::get(), "*", "wb4_mst_out_if", wb4_mst_out_if);
   uvm::uvm_config_db<std::string>::set(uvm::uvm_root::get(), "*", "uvmtest_name", uvmtest_name);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_depth", UUT_P_DEPTH);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_data_i_width", UUT_P_DATA_I_MSB+1);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_data_o_width", UUT_P_DATA_O_MSB+1);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_use_bram", UUT_P_USE_BRAM);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_nb_resp", UUT_P_NB_RESP);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_cut_through", UUT_P_CUT_THROUGH);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_wr_sync_depth", UUT_P_WR_SYNC_DEPTH);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_rd_sync_depth", UUT_P_RD_SYNC_DEPTH);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_clk_mode", UUT_P_CLK_MODE);
+  uvm::uvm_config_db<int>::set(uvm::uvm_root::get(), "*", "uut_rd_pipe_stages", UUT_P_RD_PIPE_STAGES);
+  uvm::uvm_config_db<sc_signal<uint32_t>*>::set(uvm::uvm_root::get(), "*", "wb4_in_level", &in_level);
+  uvm::uvm_config_db<sc_signal<uint32_t>*>::set(uvm::uvm_root::get(), "*", "wb4_out_level", &out_level);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_in_almost_full", &in_almost_full);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_out_almost_empty", &out_almost_empty);
+  uvm::uvm_config_db<sc_signal<uint32_t>*>::set(uvm::uvm_root::get(), "*", "wb4_in_afull_thresh", &in_afull_thresh);
+  uvm::uvm_config_db<sc_signal<uint32_t>*>::set(uvm::uvm_root::get(), "*", "wb4_out_aempty_thresh", &out_aempty_thresh);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_in_eop", &in_eop);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_in_abort", &in_abort);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_out_eop", &out_eop);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_out_abort", &out_abort);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_in_err", &in_err);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_in_rty", &in_rty);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_out_err", &out_err);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "wb4_out_rty", &out_rty);
+  uvm::uvm_config_db<sc_clock*>::set(uvm::uvm_root::get(), "*", "csr_clk", &fast_clk);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "csr_cyc", &csr_cyc);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "csr_stb", &csr_stb);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "csr_we", &csr_we);
+  uvm::uvm_config_db<sc_signal<bool>*>::set(uvm::uvm_root::get(), "*", "csr_ack", &csr_ack);
+  uvm::uvm_config_db<sc_signal<uint32_t>*>::set(uvm::uvm_root::get(), "*", "csr_adr", &csr_adr);
+  uvm::uvm_config_db<sc_signal<uint32_t>*>::set(uvm::uvm_root::get(), "*", "csr_dat_o", &csr_dat_o);
+  uvm::uvm_config_db<sc_signal<uint32_t>*>::set(uvm::uvm_root::get(), "*", "csr_dat_i", &csr_dat_i);
 #if VM_TRACE
   uvm::uvm_config_db<Vwb4_dual_clock_fifo*>::set(uvm::uvm_root::get(), "*", "uut", uut);
 #endif
@@ -37,6 +37,9 @@ Additional Comments:
 
 #include "tb_config.h"
 #include "predictor.h"
+#include "../../common/timed_model.h"
+#include "../../common/perf_analysis.h"
+#include "../../common/trace_logger.h"
 
 //--------------------------------------------------------------------------------
 // Test Bench Enviroment
@@ -52,6 +55,9 @@ public:
   wb4_agent*                 wb4_mst_in_agent;
   wb4_agent*                 wb4_mst_out_agent;
   predictor*                 prd;
+  timed_model*               tmd;
+  perf_analysis*             perf;
+  trace_logger*              trc;
   wb4_inorder_scoreboard*    in_sb;
   wb4_inorder_scoreboard*    out_sb;
 
@@ -88,6 +94,37 @@ public:
     in_sb             = wb4_inorder_scoreboard::type_id::create("in_sb", this);
     out_sb            = wb4_inorder_scoreboard::type_id::create("out_sb", this);
     prd               = predictor::type_id::create("prd");
+    tmd               = timed_model::type_id::create("tmd", this);
+    perf              = perf_analysis::type_id::create("perf", this);
+    trc               = trace_logger::type_id::create("trc", this);
+
+    // Size the reference model to the uut parameters, see sc_main.
+    int uut_depth, uut_data_i_width, uut_data_o_width;
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_depth", uut_depth) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_i_width", uut_data_i_width) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_o_width", uut_data_o_width))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    prd->configure(uut_depth, uut_data_i_width, uut_data_o_width);
+
+    // Cycle level ACK/STALL checks, off unless the test sets "timed_model".
+    int timed = 0, uut_wr_sync_depth, uut_rd_sync_depth;
+    uvm::uvm_config_db<int>::get(this, "", "timed_model", timed);
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_wr_sync_depth", uut_wr_sync_depth) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_rd_sync_depth", uut_rd_sync_depth))
+      UVM_FATAL("NOCFG", "UUT synchronizer parameters must be set for: " + get_full_name());
+    tmd->enabled    = (timed != 0);
+    tmd->depth      = uut_depth;
+    tmd->wr_ack_lat = 1;
+    tmd->rd_ack_lat = 1;
+    tmd->wr_vis_lat = uut_wr_sync_depth + 3;
+    tmd->rd_vis_lat = uut_rd_sync_depth + 3;
+
+    // Binary transaction trace, off unless the test sets "trace".
+    int trace = 0;
+    uvm::uvm_config_db<int>::get(this, "", "trace", trace);
+    trc->enabled    = (trace != 0);
+    trc->in_domain  = 0; // fast_clk
+    trc->out_domain = 1; // slow_clk
 
 #if VM_TRACE
     if(! uvm::uvm_config_db<Vwb4_dual_clock_fifo*>::get(this, "*", "uut", uut))
@@ -110,6 +147,13 @@ public:
     rst_agent->cfg         = cfg->rst_cfg;
     wb4_mst_in_agent->cfg  = cfg->wb4_mst_in_cfg;
     wb4_mst_out_agent->cfg = cfg->wb4_mst_out_cfg;
+    tmd->in_vif            = cfg->wb4_mst_in_cfg->vif;
+    tmd->out_vif           = cfg->wb4_mst_out_cfg->vif;
+    perf->prd              = prd;
+    perf->in_vif           = cfg->wb4_mst_in_cfg->vif;
+    perf->out_vif          = cfg->wb4_mst_out_cfg->vif;
+    trc->in_vif            = cfg->wb4_mst_in_cfg->vif;
+    trc->out_vif           = cfg->wb4_mst_out_cfg->vif;
   }
 
   
@@ -119,6 +163,14 @@ public:
     wb4_mst_in_agent->mon->ap.connect(prd->in_ap);
     wb4_mst_out_agent->mon->ap.connect(prd->out_ap);
 
+    // Latency/Throughput Analysis Connections, after the predictor's
+    wb4_mst_in_agent->mon->ap.connect(perf->in_ap);
+    wb4_mst_out_agent->mon->ap.connect(perf->out_ap);
+
+    // Transaction Trace Connections
+    wb4_mst_in_agent->mon->ap.connect(trc->in_ap);
+    wb4_mst_out_agent->mon->ap.connect(trc->out_ap);
+
     // In Scoreboard Connections
     wb4_mst_in_agent->mon->ap.connect(in_sb->observed_ap);
     prd->in_to_sb_ap.connect(in_sb->expected_ap);
@@ -111,7 +111,7 @@ public:
 
 
   void report_phase(uvm::uvm_phase& phase) {
-    if(env->in_sb->error || env->out_sb->error)
+    if(env->in_sb->error || env->out_sb->error || env->tmd->errors != 0)
       test_pass = false;
 
     if(test_pass)
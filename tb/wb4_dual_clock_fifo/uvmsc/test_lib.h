@@ -22,13 +22,77 @@
 File name      : test_lib.h
 Author         : Jose R Garcia (jg-fossh@protonmail.com)
 Project Name   : Wishbone B4 FIFO Library
-Class(es) Name : test_fifo_default; test_fifo_one_wr_rd; test_fifo_rd_empty; test_fifo_random
+Class(es) Name : test_fifo_default; test_fifo_one_wr_rd; test_fifo_rd_empty; test_fifo_random;
+                 test_fifo_packet; test_fifo_latency; test_fifo_nb_resp;
+                 test_fifo_stats; test_fifo_level; test_fifo_1_to_N;
+                 test_fifo_depth; test_fifo_rd_pipe; test_fifo_gearbox;
+                 test_fifo_lut
 Description    : 
     test_fifo_default   -> test with complete code coverage.
     test_fifo_one_wr_rd -> One write followed by a read
     test_fifo_rd_empty  -> This test create two parallel operations. A read and 
                            a write starting occuring at the same time.
-    test_fifo_random    -> Randomized transactons
+    test_fifo_random    -> Randomized transactons, ACK/STALL timing checked
+                           against the timed model, traced to
+                           logs/trace.bin.
+    test_fifo_packet    -> A committed frame, an aborted frame and a frame
+                           held back until its EOP. Store-and-forward drops
+                           the aborted frame, cut-through reads it out with
+                           ABORT on its last word. ERR must stay low. Needs
+                           the packet UUT, uut_params="-GP_PACKET=1", add
+                           -GP_CUT_THROUGH=1 for cut-through.
+    test_fifo_latency   -> Measures the write-to-readable latency, from the
+                           write side level rising to the read side level
+                           rising, and fails outside P_RD_SYNC_DEPTH to
+                           P_RD_SYNC_DEPTH+1 read clocks. With fewer stages
+                           than the asynchronous default (2) it must also
+                           beat the default by a read clock. The related
+                           clock handoff has no stages, it must come within
+                           one read clock: uut_params="-GP_CLK_MODE=1
+                           -GP_USE_BRAM=0".
+    test_fifo_nb_resp   -> Writes past full and reads past empty, every
+                           refused strobe must come back with RTY (or ERR)
+                           instead of stalling the bus, never on the other
+                           line or with ACK. Needs uut_params="-GP_NB_RESP=1"
+                           or "-GP_NB_RESP=2".
+    test_fifo_stats     -> Fills the FIFO, writes past full, empties it and
+                           reads past empty, then snapshots and clears the
+                           statistics counters over the CSR port and checks
+                           all seven. Needs uut_params="-GP_STATS=1".
+    test_fifo_level     -> Fills and empties the FIFO one word at a time and
+                           checks both levels and the almost full/empty flags
+                           on every step across their thresholds once the
+                           pointers crossed the domains. 1 to 1.
+    test_fifo_1_to_N    -> Reads a full FIFO out and streams twice its depth
+                           through it, checks the sub-words come out least
+                           significant first at one per read clock, across
+                           the word boundaries. Needs
+                           uut_params="-GP_DATA_I_MSB=31 -GP_DATA_O_MSB=7".
+    test_fifo_depth     -> Non power of 2 depth, LUT backend. The LUT
+                           pointers keep their binary wrap, 2^($clog2(P_DEPTH)+1)
+                           (256 for 96 entries), the memory index wraps at
+                           P_DEPTH. Skews the pointers, then fills to full and
+                           empties until the pointers wrapped twice, and
+                           checks both levels and the full/empty stalls one
+                           word either side of the boundaries. Needs
+                           uut_params="-GP_DEPTH=96 -GP_USE_BRAM=0".
+    test_fifo_rd_pipe   -> Fills the FIFO and reads it back to back through
+                           the read pipeline, checks one word per read clock.
+                           Needs uut_params="-GP_RD_PIPE_STAGES=1", run it
+                           again with -GP_RD_PIPE_STAGES=2.
+    test_fifo_gearbox   -> Streams twice the depth through a gearbox FIFO,
+                           the words must come out in order and the port
+                           moving fewer bits per ns must take a beat on every
+                           one of its clocks. Needs uut_params=
+                           "-GP_DATA_I_MSB=23 -GP_DATA_O_MSB=31", run it again
+                           with "-GP_DATA_I_MSB=9 -GP_DATA_O_MSB=7".
+    test_fifo_lut       -> LUT backend. Streams four pointer wraps of words
+                           into the FIFO while the slower read port drains
+                           it, so it sits at full with the pointers at every
+                           position, and checks the write level never goes
+                           past P_DEPTH. An overwritten word fails the
+                           scoreboard. Needs uut_params="-GP_USE_BRAM=0
+                           -GP_DEPTH=16".
 Additional Comments:
  
 */
@@ -36,11 +100,16 @@ Additional Comments:
 #ifndef TEST_LIB_H_
 #define TEST_LIB_H_
 
+#include <algorithm>
 #include <ctime>
+#include <numeric>
+#include <string>
+#include <vector>
 
 #include <systemc>
 #include <uvm>
 #include "test_base.h"
+#include "../../common/ack_rate_subscriber.h"
 
 
 //--------------------------------------------------------------------------------
@@ -327,6 +396,12 @@ public:
     SC_THREAD(write_tx);
     SC_THREAD(read_tx);
   }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    uvm::uvm_config_db<int>::set(this, "env", "timed_model", 1);
+    uvm::uvm_config_db<int>::set(this, "env", "trace", 1);
+    test_base::build_phase(phase);
+  }
   
   void main_phase(uvm::uvm_phase& phase){
     UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
@@ -385,4 +460,1267 @@ public:
 }; // test_fifo_random
 
 
+
+//--------------------------------------------------------------------------------
+// test_fifo_packet
+//--------------------------------------------------------------------------------
+class test_fifo_packet : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_signal<bool>*     in_eop;
+  sc_core::sc_signal<bool>*     in_abort;
+  sc_core::sc_signal<bool>*     out_abort;
+  sc_core::sc_signal<bool>*     out_err;
+  sc_core::sc_signal<uint32_t>* out_level;
+  sc_core::sc_event trig;
+  int cut_through;
+  int aborts_seen;
+
+  SC_HAS_PROCESS(test_fifo_packet);
+  UVM_COMPONENT_UTILS(test_fifo_packet);
+
+  test_fifo_packet( uvm::uvm_component_name name = "test_fifo_packet") : test_base(name){
+    test_pass   = true;
+    aborts_seen = 0;
+    SC_THREAD(out_frame_mon);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_eop", in_eop) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_abort", in_abort) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_abort", out_abort) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_err", out_err) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_level", out_level))
+      UVM_FATAL("NOSIG", "Packet side band must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_cut_through", cut_through))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    env->prd->packet_mode = true;
+    env->prd->cut_through = (cut_through == 1);
+  }
+
+  // Writes n words starting at first, the last one with EOP or abort if asked.
+  void write_frame(int first, int n, bool eop, bool abort) {
+    for(int iter = 0; iter < n; ++iter) {
+      if(iter == n-1) {
+        in_eop->write(eop);
+        in_abort->write(abort);
+      }
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = first+iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    // Let the monitor see the last beat before touching the predictor.
+    sc_core::wait(sc_core::sc_time(10.0, sc_core::SC_NS));
+    if(eop)
+      env->prd->end_of_frame();
+    if(abort)
+      env->prd->abort_frame();
+    in_eop->write(false);
+    in_abort->write(false);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    this->trig.notify();
+    // Cut-through lets every word through, the aborted frame included.
+    const unsigned visible = (cut_through == 1) ? 8+6+5 : 8;
+    const int      n_reads = (cut_through == 1) ? 8+6+6 : 8+6;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Writing a committed 8 word frame", uvm::UVM_LOW);
+    write_frame(0x10, 8, true, false);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Writing an aborted frame", uvm::UVM_LOW);
+    write_frame(0x20, 6, false, true);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Writing a frame without its EOP", uvm::UVM_LOW);
+    write_frame(0x30, 5, false, false);
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+    if(out_level->read() != visible) {
+      UVM_ERROR(get_name()+"::"+__func__, "Read side level is "+std::to_string(out_level->read())+
+        ", expected "+std::to_string(visible));
+      test_pass = false;
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Closing the frame", uvm::UVM_LOW);
+    write_frame(0x35, 1, true, false);
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+
+    UVM_INFO(get_name()+"::"+__func__, ">  Reading the frames", uvm::UVM_LOW);
+    for(int iter = 0; iter < n_reads; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    const int aborts = (cut_through == 1) ? 1 : 0;
+    if(aborts_seen != aborts) {
+      UVM_ERROR(get_name()+"::"+__func__, "Words read with ABORT: "+std::to_string(aborts_seen)+
+        ", expected "+std::to_string(aborts));
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+
+    // An aborted frame word comes out with ACK and ABORT, never with ERR.
+    void out_frame_mon() {
+      wait(trig); // Wait for the event to be triggered
+      while(true) {
+        sc_core::wait(out_abort->posedge_event() | out_err->posedge_event());
+        if(out_err->read()) {
+          UVM_ERROR(get_name()+"::"+__func__, "ERR on a packet read");
+          test_pass = false;
+        }
+        if(out_abort->read())
+          aborts_seen++;
+      }
+    }
+}; // test_fifo_packet
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_latency
+//--------------------------------------------------------------------------------
+class test_fifo_latency : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_signal<uint32_t>* in_level;
+  sc_core::sc_signal<uint32_t>* out_level;
+  sc_core::sc_time rd_period;
+  int rd_sync_depth;
+  int clk_mode;
+  int use_bram;
+
+  UVM_COMPONENT_UTILS(test_fifo_latency);
+
+  // Asynchronous clocks default, P_RD_SYNC_DEPTH=2.
+  static const int async_sync_depth = 2;
+
+  test_fifo_latency( uvm::uvm_component_name name = "test_fifo_latency") : test_base(name){
+    test_pass = true;
+    rd_period = sc_core::sc_time(10.0, sc_core::SC_NS);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_level", out_level))
+      UVM_FATAL("NOSIG", "Fill level side band must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_rd_sync_depth", rd_sync_depth) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_clk_mode", clk_mode) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_use_bram", use_bram))
+      UVM_FATAL("NOCFG", "UUT synchronizer parameters must be set for: " + get_full_name());
+    // The related clock handoff skips the synchronizers, LUT backend only.
+    if(clk_mode == 1 && use_bram == 0)
+      rd_sync_depth = 0;
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    const int samples = 16;
+    sc_core::sc_time total = sc_core::SC_ZERO_TIME;
+    sc_core::sc_time worst = sc_core::SC_ZERO_TIME;
+    sc_core::sc_time best  = sc_core::sc_time(1.0, sc_core::SC_SEC);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Single words through the empty FIFO", uvm::UVM_LOW);
+    for(int iter = 0; iter < samples; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = iter % 4; // Walk the write across the read clock phase
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+      // Both levels are registered, they rise on the write edge and on the
+      // read edge that first sees the word.
+      while(in_level->read() == 0)
+        sc_core::wait(in_level->value_changed_event());
+      sc_core::sc_time written = sc_core::sc_time_stamp();
+      while(out_level->read() == 0)
+        sc_core::wait(out_level->value_changed_event());
+      sc_core::sc_time latency = sc_core::sc_time_stamp() - written;
+      total += latency;
+      if(latency > worst)
+        worst = latency;
+      if(latency < best)
+        best = latency;
+
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+      // Let both levels settle back to empty.
+      sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "Write-to-readable latency, average: "+
+      (total/samples).to_string()+", best: "+best.to_string()+", worst: "+worst.to_string(), uvm::UVM_NONE);
+
+    // The word crosses P_RD_SYNC_DEPTH read registers after the first read
+    // edge past the write (none with related clocks), the level register
+    // adds one more.
+    sc_core::sc_time async_worst = (async_sync_depth+1)*rd_period;
+    UVM_INFO(get_name()+"::"+__func__, "Asynchronous default worst: "+async_worst.to_string(), uvm::UVM_NONE);
+    if(worst > (rd_sync_depth+1)*rd_period || best <= rd_sync_depth*rd_period) {
+      UVM_ERROR(get_name()+"::"+__func__, "Latency outside "+std::to_string(rd_sync_depth)+" to "+
+        std::to_string(rd_sync_depth+1)+" read clocks");
+      test_pass = false;
+    }
+    if(rd_sync_depth < async_sync_depth && worst > async_worst-rd_period) {
+      UVM_ERROR(get_name()+"::"+__func__, "Fewer synchronizer stages but no faster than the asynchronous default");
+      test_pass = false;
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_latency
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_nb_resp
+//--------------------------------------------------------------------------------
+class test_fifo_nb_resp : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_signal<bool>* in_err;
+  sc_core::sc_signal<bool>* in_rty;
+  sc_core::sc_signal<bool>* out_err;
+  sc_core::sc_signal<bool>* out_rty;
+  sc_core::sc_signal<bool>* out_abort;
+  wb4_bfm* in_vif;
+  wb4_bfm* out_vif;
+  sc_core::sc_event trig;
+  int nb_resp;
+
+  SC_HAS_PROCESS(test_fifo_nb_resp);
+  UVM_COMPONENT_UTILS(test_fifo_nb_resp);
+
+  test_fifo_nb_resp( uvm::uvm_component_name name = "test_fifo_nb_resp") : test_base(name){
+    test_pass = true;
+    SC_THREAD(in_resp_mon);
+    SC_THREAD(out_resp_mon);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_err", in_err) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_rty", in_rty) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_err", out_err) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_rty", out_rty) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_abort", out_abort))
+      UVM_FATAL("NOSIG", "Response side band must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_in_if", in_vif) ||
+       ! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_out_if", out_vif))
+      UVM_FATAL("NOVIF", "Virtual interfaces must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_nb_resp", nb_resp))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    env->prd->nb_resp = nb_resp;
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(nb_resp == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "The FIFO stalls, run with -GP_NB_RESP=1 or -GP_NB_RESP=2");
+      test_pass = false;
+    }
+    this->trig.notify();
+    const int extra = 4;
+
+    // The beats are spaced so every refusal is its own RTY/ERR pulse.
+    UVM_INFO(get_name()+"::"+__func__, "> Writing past full", uvm::UVM_LOW);
+    for(int iter = 0; iter < env->prd->depth+extra; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 2;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing the FIFO to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+
+    UVM_INFO(get_name()+"::"+__func__, "> Reading past empty", uvm::UVM_LOW);
+    for(int iter = 0; iter < env->prd->depth+extra; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 2;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+
+    // A refusal is answered on the P_NB_RESP line alone, never with ACK.
+    void check_refusal(const std::string& port, bool err, bool rty, bool ack) {
+      if((nb_resp == 1 && err) || (nb_resp == 2 && rty) || ack) {
+        UVM_ERROR(get_name()+"::"+__func__, port+" refusal with ERR="+std::to_string(err)+
+          " RTY="+std::to_string(rty)+" ACK="+std::to_string(ack));
+        test_pass = false;
+      }
+    }
+
+    // Counts the refusals on the write port
+    void in_resp_mon() {
+      wait(trig); // Wait for the event to be triggered
+      while(true) {
+        sc_core::wait(in_rty->posedge_event() | in_err->posedge_event());
+        check_refusal("Write", in_err->read(), in_rty->read(), in_vif->ack.read());
+        env->prd->refused_in();
+      }
+    }
+
+    // Counts the refusals on the read port, an abort is not one.
+    void out_resp_mon() {
+      wait(trig); // Wait for the event to be triggered
+      while(true) {
+        sc_core::wait(out_rty->posedge_event() | out_err->posedge_event());
+        check_refusal("Read", out_err->read() || out_abort->read(), out_rty->read(), out_vif->ack.read());
+        env->prd->refused_out();
+      }
+    }
+}; // test_fifo_nb_resp
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_stats
+//--------------------------------------------------------------------------------
+class test_fifo_stats : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_clock*            csr_clk;
+  sc_core::sc_signal<bool>*     csr_cyc;
+  sc_core::sc_signal<bool>*     csr_stb;
+  sc_core::sc_signal<bool>*     csr_we;
+  sc_core::sc_signal<bool>*     csr_ack;
+  sc_core::sc_signal<uint32_t>* csr_adr;
+  sc_core::sc_signal<uint32_t>* csr_dat_o;
+  sc_core::sc_signal<uint32_t>* csr_dat_i;
+  sc_core::sc_event release_trig; // One read frees the write stalled on full
+  sc_core::sc_event refill_trig;  // One write ends the read stalled on empty
+  sc_core::sc_time  hold;         // How long the other side is kept stalled
+  sc_core::sc_time  wr_period;
+  sc_core::sc_time  rd_period;
+  sc_core::sc_time  settle;
+  int slack;   // Clocks a stall may outlast hold, the flags crossing back
+  int depth;
+  int next_wr; // Value of the next word written, counts up
+
+  SC_HAS_PROCESS(test_fifo_stats);
+  UVM_COMPONENT_UTILS(test_fifo_stats);
+
+  test_fifo_stats( uvm::uvm_component_name name = "test_fifo_stats") : test_base(name){
+    test_pass = true;
+    hold      = sc_core::sc_time(200.0, sc_core::SC_NS);
+    wr_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    rd_period = sc_core::sc_time(10.0, sc_core::SC_NS);
+    settle    = sc_core::sc_time(100.0, sc_core::SC_NS);
+    slack     = 12;
+    next_wr   = 0;
+    SC_THREAD(release_tx);
+    SC_THREAD(refill_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_clock*>::get(this, "*", "csr_clk", csr_clk) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_cyc", csr_cyc) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_stb", csr_stb) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_we", csr_we) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_ack", csr_ack) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "csr_adr", csr_adr) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "csr_dat_o", csr_dat_o) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "csr_dat_i", csr_dat_i))
+      UVM_FATAL("NOSIG", "Statistics CSR port must be set for: " + get_full_name());
+    if (!uvm::uvm_config_db<int>::get(this, "*", "uut_depth", depth))
+      UVM_FATAL("NOCFG", "UUT depth must be set for: " + get_full_name());
+  }
+
+  void write_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = next_wr++;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+  }
+
+  void read_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+  }
+
+  // One single beat CSR cycle, returns the read data.
+  uint32_t csr_access(bool we, uint32_t adr, uint32_t dat) {
+    sc_core::wait(csr_clk->posedge_event());
+    csr_cyc->write(true);
+    csr_stb->write(true);
+    csr_we->write(we);
+    csr_adr->write(adr);
+    csr_dat_o->write(dat);
+    sc_core::wait(csr_clk->posedge_event());
+    csr_stb->write(false);
+    while(!csr_ack->read())
+      sc_core::wait(csr_clk->posedge_event());
+    uint32_t rdata = csr_dat_i->read();
+    csr_cyc->write(false);
+    csr_we->write(false);
+    return rdata;
+  }
+
+  // Snapshot and/or clear, then wait for the read side to catch up.
+  void csr_command(uint32_t cmd) {
+    csr_access(true, 0, cmd);
+    while(csr_access(false, 0, 0) & 1) {}
+  }
+
+  void check_counter(uint32_t adr, std::string name, uint32_t lo, uint32_t hi) {
+    uint32_t count = csr_access(false, adr, 0);
+    std::string expected = std::to_string(lo);
+    if(hi != lo)
+      expected += " to "+std::to_string(hi);
+    if(count < lo || count > hi) {
+      UVM_ERROR(get_name()+"::"+__func__, name+": "+std::to_string(count)+", expected: "+expected);
+      test_pass = false;
+    }
+    else
+      UVM_INFO(get_name()+"::"+__func__, name+": "+std::to_string(count), uvm::UVM_LOW);
+  }
+
+  void check_counter(uint32_t adr, std::string name, uint32_t expected) {
+    check_counter(adr, name, expected, expected);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    // Both stalls start with the strobe and end once the helper's word
+    // crossed, so each one lasts hold give or take a clock, plus the slack.
+    const uint32_t wr_stalls = hold/wr_period;
+    const uint32_t rd_stalls = hold/rd_period;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO", uvm::UVM_LOW);
+    write_words(depth);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Writing past full, a read frees it later", uvm::UVM_LOW);
+    release_trig.notify();
+    write_words(1);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Emptying the FIFO", uvm::UVM_LOW);
+    read_words(depth);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Reading past empty, a write ends it later", uvm::UVM_LOW);
+    refill_trig.notify();
+    read_words(1);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Snapshot and clear", uvm::UVM_LOW);
+    csr_command(3);
+    check_counter(1, "WRITES", depth+2);
+    check_counter(2, "READS", depth+2);
+    check_counter(3, "WR_STALLS", wr_stalls-1, wr_stalls+slack);
+    check_counter(4, "RD_STALLS", rd_stalls-1, rd_stalls+slack);
+    check_counter(5, "HIGH_WATER", depth);
+    check_counter(6, "OVERFLOWS", 1);
+    check_counter(7, "UNDERFLOWS", 1);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Snapshot after the clear", uvm::UVM_LOW);
+    csr_command(1);
+    for(uint32_t adr = 1; adr < 8; ++adr)
+      check_counter(adr, "Counter "+std::to_string(adr), 0);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(settle);
+
+    phase.drop_objection(this);
+  }
+
+  // Reads one word hold after the write into the full FIFO started.
+  void release_tx() {
+    while(true) {
+      sc_core::wait(release_trig);
+      sc_core::wait(hold);
+      read_words(1);
+    }
+  }
+
+  // Writes one word hold after the read from the empty FIFO started.
+  void refill_tx() {
+    while(true) {
+      sc_core::wait(refill_trig);
+      sc_core::wait(hold);
+      write_words(1);
+    }
+  }
+}; // test_fifo_stats
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_level
+//--------------------------------------------------------------------------------
+class test_fifo_level : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_signal<uint32_t>* in_level;
+  sc_core::sc_signal<uint32_t>* out_level;
+  sc_core::sc_signal<bool>*     in_almost_full;
+  sc_core::sc_signal<bool>*     out_almost_empty;
+  sc_core::sc_signal<uint32_t>* in_afull_thresh;
+  sc_core::sc_signal<uint32_t>* out_aempty_thresh;
+  int afull;  // Almost Full when level >= afull
+  int aempty; // Almost Empty when level <= aempty
+
+  UVM_COMPONENT_UTILS(test_fifo_level);
+
+  test_fifo_level( uvm::uvm_component_name name = "test_fifo_level") : test_base(name){
+    test_pass = true;
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_level", out_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_almost_full", in_almost_full) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_almost_empty", out_almost_empty) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_afull_thresh", in_afull_thresh) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_aempty_thresh", out_aempty_thresh))
+      UVM_FATAL("NOSIG", "Fill level side band must be set for: " + get_full_name());
+  }
+
+  // Both sides must agree on the level once the FIFO settled, the flags must
+  // flip exactly at their thresholds.
+  void check_level(int words) {
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+    int in_l  = in_level->read();
+    int out_l = out_level->read();
+    if(in_l != words || out_l != words ||
+       in_almost_full->read() != (words >= afull) ||
+       out_almost_empty->read() != (words <= aempty)) {
+      UVM_ERROR(get_name()+"::"+__func__, "With "+std::to_string(words)+" words stored, levels: "+
+        std::to_string(in_l)+"/"+std::to_string(out_l)+", almost full: "+
+        std::to_string(in_almost_full->read())+", almost empty: "+std::to_string(out_almost_empty->read()));
+      test_pass = false;
+    }
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    // Same as the P_ALMOST_FULL/P_ALMOST_EMPTY defaults, so the test holds
+    // with and without P_PROG_THRESH=1.
+    afull  = (env->prd->depth*3)/4;
+    aempty = env->prd->depth/4;
+    in_afull_thresh->write(afull);
+    out_aempty_thresh->write(aempty);
+    check_level(0);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling one word at a time", uvm::UVM_LOW);
+    for(int iter = 0; iter < env->prd->depth; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+      check_level(iter+1);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, ">  Emptying one word at a time", uvm::UVM_LOW);
+    for(int iter = env->prd->depth; iter > 0; --iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+      check_level(iter-1);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_level
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_1_to_N
+//--------------------------------------------------------------------------------
+class test_fifo_1_to_N : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  sc_core::sc_time  out_period;
+  int data_i_width;
+  int data_o_width;
+  int lanes;   // Sub-words per input word
+  int n_words; // Input words streamed by write_tx
+
+  SC_HAS_PROCESS(test_fifo_1_to_N);
+  UVM_COMPONENT_UTILS(test_fifo_1_to_N);
+
+  test_fifo_1_to_N( uvm::uvm_component_name name = "test_fifo_1_to_N") : test_base(name){
+    test_pass  = true;
+    out_period = sc_core::sc_time(10.0, sc_core::SC_NS);
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_data_i_width", data_i_width) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_o_width", data_o_width))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    lanes = (data_o_width < data_i_width) ? data_i_width/data_o_width : 1;
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  // Sub-word j of input word k counts up, k*lanes+j, least significant first.
+  uint32_t word(int k) {
+    uint64_t data = 0;
+    uint64_t mask = (1ULL << data_o_width) - 1;
+    for(int j = 0; j < lanes; ++j)
+      data |= ((uint64_t)(k*lanes+j) & mask) << (j*data_o_width);
+    return (uint32_t)data;
+  }
+
+  // The sub-words must come out back-to-back, across the word boundaries too.
+  void check_rate(const std::string& what, int sub_words) {
+    double out_r = out_rate->rate(out_period);
+    UVM_INFO(get_name()+"::"+__func__, "> "+what+": read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    if((int)out_rate->stamps.size() != sub_words || out_r < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, what+": "+std::to_string(out_rate->stamps.size())+" of "+
+        std::to_string(sub_words)+" sub-words read, below one per clock");
+      test_pass = false;
+    }
+    out_rate->stamps.clear();
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(data_i_width <= data_o_width || (data_i_width % data_o_width) != 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not a 1 to N FIFO, needs uut_params=\"-GP_DATA_I_MSB=31 -GP_DATA_O_MSB=7\"");
+      test_pass = false;
+    }
+    const int depth = env->prd->depth;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO with "+std::to_string(depth)+" words", uvm::UVM_LOW);
+    for(int iter = 0; iter < depth; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = word(iter);
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+    out_rate->stamps.clear();
+
+    UVM_INFO(get_name()+"::"+__func__, "> Reading the full FIFO out", uvm::UVM_LOW);
+    for(int iter = 0; iter < depth*lanes; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+    check_rate("From full", depth*lanes);
+
+    // Writes run ahead until the FIFO is full, then wait on the reader, the
+    // pointers wrap twice.
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming from an empty FIFO", uvm::UVM_LOW);
+    n_words = 2*depth;
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+    check_rate("Streaming", n_words*lanes);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words; ++iter) {
+          write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+          write_seq->req->delay = 0;
+          write_seq->req->dat_o = word(iter);
+          write_seq->start(env->wb4_mst_in_agent->sqr);
+        }
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words*lanes; ++iter) {
+          read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+          read_seq->req->adr      = 0;
+          read_seq->req->delay    = 0;
+          read_seq->req->rsp_clks = 8;
+          read_seq->start(env->wb4_mst_out_agent->sqr);
+        }
+        read_done.notify();
+      }
+    }
+}; // test_fifo_1_to_N
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_depth
+//--------------------------------------------------------------------------------
+class test_fifo_depth : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_signal<uint32_t>* in_level;
+  sc_core::sc_signal<uint32_t>* out_level;
+  wb4_bfm* in_vif;
+  wb4_bfm* out_vif;
+  sc_core::sc_time settle;
+  int next_wr; // Value of the next word written, counts up
+
+  UVM_COMPONENT_UTILS(test_fifo_depth);
+
+  test_fifo_depth( uvm::uvm_component_name name = "test_fifo_depth") : test_base(name){
+    test_pass = true;
+    settle    = sc_core::sc_time(100.0, sc_core::SC_NS);
+    next_wr   = 0;
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_level", out_level))
+      UVM_FATAL("NOSIG", "Fill level ports must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_in_if", in_vif) ||
+       ! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_out_if", out_vif))
+      UVM_FATAL("NOVIF", "Virtual interfaces must be set for: " + get_full_name());
+  }
+
+  void write_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = (next_wr++) & 0xFF;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    sc_core::wait(settle);
+  }
+
+  void read_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+    sc_core::wait(settle);
+  }
+
+  // Both levels and the full/empty stalls once the FIFO settled at level.
+  void check_level(const std::string& what, int level) {
+    const int depth = env->prd->depth;
+    bool ok = (int)in_level->read() == level && (int)out_level->read() == level &&
+              in_vif->stall.read() == (level == depth) && out_vif->stall.read() == (level == 0);
+    if(!ok) {
+      UVM_ERROR(get_name()+"::"+__func__, what+": expected level "+std::to_string(level)+
+        ", write level "+std::to_string(in_level->read())+" stall "+std::to_string(in_vif->stall.read())+
+        ", read level "+std::to_string(out_level->read())+" stall "+std::to_string(out_vif->stall.read()));
+      test_pass = false;
+    }
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    const int depth = env->prd->depth;
+    if((depth & (depth-1)) == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "P_DEPTH="+std::to_string(depth)+" is a power of 2, run with -GP_DEPTH=96");
+      test_pass = false;
+    }
+
+    // Skew the pointers so full falls in the middle of the memory.
+    UVM_INFO(get_name()+"::"+__func__, "> Moving the pointers off 0", uvm::UVM_LOW);
+    write_words(depth/3);
+    read_words(depth/3);
+    check_level("Offset", 0);
+
+    // The LUT pointers are $clog2(P_DEPTH)+1 bits wide, enough rounds of
+    // P_DEPTH+1 words to wrap them twice.
+    int ptr_span = 1;
+    while(ptr_span < depth)
+      ptr_span <<= 1;
+    ptr_span <<= 1;
+    const int rounds = (2*ptr_span)/(depth+1) + 1;
+    for(int round = 0; round < rounds; ++round) {
+      UVM_INFO(get_name()+"::"+__func__, "> Round "+std::to_string(round)+", to full and back", uvm::UVM_LOW);
+      write_words(depth-1);
+      check_level("One word short of full", depth-1);
+      write_words(1);
+      check_level("Full", depth);
+      read_words(1);
+      check_level("One word out of full", depth-1);
+      write_words(1);
+      check_level("Full again", depth);
+      read_words(depth-1);
+      check_level("One word left", 1);
+      read_words(1);
+      check_level("Empty", 0);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_depth
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_rd_pipe
+//--------------------------------------------------------------------------------
+class test_fifo_rd_pipe : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_time rd_period;
+  sc_core::sc_time settle;
+  int depth;
+  int stages;
+
+  UVM_COMPONENT_UTILS(test_fifo_rd_pipe);
+
+  test_fifo_rd_pipe( uvm::uvm_component_name name = "test_fifo_rd_pipe") : test_base(name){
+    test_pass = true;
+    rd_period = sc_core::sc_time(10.0, sc_core::SC_NS);
+    settle    = sc_core::sc_time(100.0, sc_core::SC_NS);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<int>::get(this, "*", "uut_depth", depth) ||
+        !uvm::uvm_config_db<int>::get(this, "*", "uut_rd_pipe_stages", stages))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void write_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+  }
+
+  void read_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(stages == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "The read pipeline is off, P_RD_PIPE_STAGES is 0");
+      test_pass = false;
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO", uvm::UVM_LOW);
+    write_words(depth);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Reading it back to back through "+std::to_string(stages)+" stages", uvm::UVM_LOW);
+    out_rate->stamps.clear();
+    read_words(depth);
+    sc_core::wait(settle);
+
+    double out_r = out_rate->rate(rd_period);
+    UVM_INFO(get_name()+"::"+__func__, "> Read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    if(out_rate->stamps.size() != static_cast<size_t>(depth) || out_r < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Sustained read through the pipeline is below one word per clock");
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_rd_pipe
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_gearbox
+//--------------------------------------------------------------------------------
+class test_fifo_gearbox : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  sc_core::sc_time  in_period;
+  sc_core::sc_time  out_period;
+  int data_i_width;
+  int data_o_width;
+  int n_in;  // Input words streamed by write_tx
+  int n_out; // Output words read by read_tx, the same bits
+
+  SC_HAS_PROCESS(test_fifo_gearbox);
+  UVM_COMPONENT_UTILS(test_fifo_gearbox);
+
+  test_fifo_gearbox( uvm::uvm_component_name name = "test_fifo_gearbox") : test_base(name){
+    test_pass  = true;
+    in_period  = sc_core::sc_time(5.0, sc_core::SC_NS);
+    out_period = sc_core::sc_time(10.0, sc_core::SC_NS);
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_data_i_width", data_i_width) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_o_width", data_o_width))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if((data_i_width % data_o_width) == 0 || (data_o_width % data_i_width) == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not a gearbox FIFO, run with -GP_DATA_I_MSB=23 -GP_DATA_O_MSB=31 or -GP_DATA_I_MSB=9 -GP_DATA_O_MSB=7");
+      test_pass = false;
+    }
+    // Whole periods of the gearbox, twice the FIFO in stored (wider) words
+    // so the pointers wrap twice.
+    const int wide   = std::max(data_i_width, data_o_width);
+    const int period = data_i_width/std::gcd(data_i_width, data_o_width)*data_o_width;
+    const int turns  = (2*env->prd->depth*wide + period-1)/period;
+    n_in  = turns*period/data_i_width;
+    n_out = turns*period/data_o_width;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming "+std::to_string(n_in)+" words in, "+
+      std::to_string(n_out)+" words out", uvm::UVM_LOW);
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+
+    // The port moving fewer bits per ns sets the pace, it must take a beat on
+    // every one of its clocks. The other one idles as much as the ratio of
+    // the two needs and no more, as the same bits go through both.
+    const bool in_paced = data_i_width*out_period < data_o_width*in_period;
+    const ack_rate_subscriber* paced = in_paced ? in_rate : out_rate;
+    double rate = paced->rate(in_paced ? in_period : out_period);
+    UVM_INFO(get_name()+"::"+__func__, std::string("> ")+(in_paced ? "Write" : "Read")+" acks/clk "+
+      std::to_string(rate), uvm::UVM_LOW);
+    if((int)in_rate->stamps.size() != n_in || (int)out_rate->stamps.size() != n_out || rate < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, std::string(in_paced ? "Write" : "Read")+
+        " port idles beyond the width ratio, "+std::to_string(in_rate->stamps.size())+" of "+
+        std::to_string(n_in)+" written, "+std::to_string(out_rate->stamps.size())+" of "+
+        std::to_string(n_out)+" read");
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_in; ++iter) {
+          write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+          write_seq->req->delay = 0;
+          write_seq->req->dat_o = iter;
+          write_seq->start(env->wb4_mst_in_agent->sqr);
+        }
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_out; ++iter) {
+          read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+          read_seq->req->adr      = 0;
+          read_seq->req->delay    = 0;
+          read_seq->req->rsp_clks = 8;
+          read_seq->start(env->wb4_mst_out_agent->sqr);
+        }
+        read_done.notify();
+      }
+    }
+}; // test_fifo_gearbox
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_lut
+//--------------------------------------------------------------------------------
+class test_fifo_lut : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_signal<uint32_t>* in_level;
+  wb4_bfm* in_vif;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  int depth;
+  int use_bram;
+  int n_words;   // Words streamed through, four pointer wraps
+  int max_level; // Highest write side level seen
+  int full_clks; // Write clocks held at full
+
+  SC_HAS_PROCESS(test_fifo_lut);
+  UVM_COMPONENT_UTILS(test_fifo_lut);
+
+  test_fifo_lut( uvm::uvm_component_name name = "test_fifo_lut") : test_base(name){
+    test_pass = true;
+    n_words   = 0;
+    max_level = 0;
+    full_clks = 0;
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+    SC_THREAD(level_watch);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if (!uvm::uvm_config_db<int>::get(this, "*", "uut_depth", depth) ||
+        !uvm::uvm_config_db<int>::get(this, "*", "uut_use_bram", use_bram))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level))
+      UVM_FATAL("NOSIG", "Fill level ports must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_in_if", in_vif))
+      UVM_FATAL("NOVIF", "Virtual interfaces must be set for: " + get_full_name());
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(use_bram != 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not the LUT backend, run with -GP_USE_BRAM=0");
+      test_pass = false;
+    }
+    // The LUT pointers are $clog2(P_DEPTH)+1 bits wide.
+    int ptr_span = 1;
+    while(ptr_span < depth)
+      ptr_span <<= 1;
+    ptr_span <<= 1;
+    n_words = 4*ptr_span;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming "+std::to_string(n_words)+" words, the pointers wrap at "+
+      std::to_string(ptr_span), uvm::UVM_LOW);
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(100.0, sc_core::SC_NS));
+
+    UVM_INFO(get_name()+"::"+__func__, "> Highest write level "+std::to_string(max_level)+", "+
+      std::to_string(full_clks)+" write clocks at full", uvm::UVM_LOW);
+    if(max_level > depth || full_clks == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Write level reached "+std::to_string(max_level)+
+        " of "+std::to_string(depth)+(full_clks == 0 ? ", the FIFO never stalled on full" : ""));
+      test_pass = false;
+    }
+    if((int)in_rate->stamps.size() != n_words || (int)out_rate->stamps.size() != n_words ||
+       in_level->read() != 0) {
+      UVM_ERROR(get_name()+"::"+__func__, std::to_string(in_rate->stamps.size())+" written, "+
+        std::to_string(out_rate->stamps.size())+" read of "+std::to_string(n_words)+
+        ", write level "+std::to_string(in_level->read()));
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words; ++iter) {
+          write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+          write_seq->req->delay = 0;
+          write_seq->req->dat_o = iter & 0xFF;
+          write_seq->start(env->wb4_mst_in_agent->sqr);
+        }
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words; ++iter) {
+          read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+          read_seq->req->adr      = 0;
+          read_seq->req->delay    = 0;
+          read_seq->req->rsp_clks = 8;
+          read_seq->start(env->wb4_mst_out_agent->sqr);
+        }
+        read_done.notify();
+      }
+    }
+
+    // Samples the write side level and the full stall on every write clock.
+    void level_watch() {
+      while(true) {
+        wait(in_vif->clk_i.posedge_event());
+        if(n_words == 0)
+          continue;
+        max_level = std::max(max_level, (int)in_level->read());
+        if(in_vif->stall.read())
+          full_clks++;
+      }
+    }
+}; // test_fifo_lut
+
+
 #endif /* TEST_LIB_H_ */
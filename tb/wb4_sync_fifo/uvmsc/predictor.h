@@ -26,12 +26,28 @@ Class(es) Name : predictor
 Description    : Creates a non-time consuming FIFO as a 'golden' reference.
 
 Additional Comments:
+  The model is a ring of stored words allocated once by configure() with the
+  uut P_DEPTH slots, a word lands in the same slot as in the uut memory. Words
+  are masked to the uut data widths.
+  Width conversion: a stored word is as wide as the wider port and the data
+  is a bit stream through it, least significant bits first. A write appends
+  its bits to the word at m_wr, a read takes its bits from the word at m_rd,
+  so 1 to N, N to 1 and the gearbox widths are all modeled the same way.
+  flush() closes a partial N to 1 word, the bits it leaves out keep what the
+  slot held before, as in the uut memory.
+  Multi lane (the uut P_LANES): a beat carries in_count/out_count words of
+  1/lanes of the port width, lane 0 in the LSBs. The test sets the counts it
+  drives, the lanes past the read count are don't care.
  
 */
 
 #ifndef PREDICTOR_H_
 #define PREDICTOR_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include <systemc>
 #include <uvm>
 
@@ -42,6 +58,9 @@ Additional Comments:
 class predictor : public uvm::uvm_component {
 public:
   int depth;
+  int lanes;     // Words per beat at most
+  int in_count;  // Words in every write beat
+  int out_count; // Words popped by every read beat
   uvm::uvm_analysis_export<wb4_seq_item> in_ap;
   uvm::uvm_analysis_export<wb4_seq_item> out_ap;
 
@@ -56,9 +75,7 @@ public:
             : uvm_subscriber<wb4_seq_item>(name), prd(prd) {}
 
         void write(const wb4_seq_item& t) override {
-            wb4_seq_item* t_clone = new wb4_seq_item();
-            t_clone->do_copy(t);
-            prd->write_in(t_clone);
+            prd->write_in(t);
         }
     };
 
@@ -70,9 +87,7 @@ public:
             : uvm_subscriber<wb4_seq_item>(name), prd(prd) {}
             
         void write(const wb4_seq_item& t) override {
-            wb4_seq_item* t_clone = new wb4_seq_item();
-            t_clone->do_copy(t);
-            prd->write_out(t_clone);
+            prd->write_out(t);
         }
     };
 
@@ -88,7 +103,27 @@ public:
           in_ap("in_ap"),
           out_ap("out_ap"),
           in_writer("in_writer", this),
-          out_writer("out_writer", this) {}
+          out_writer("out_writer", this) {
+      configure(depth, 64, 64);
+    }
+
+    // Sizes the model to the uut, called from tb_env::build_phase.
+    void configure(int uut_depth, int data_i_width, int data_o_width, int uut_lanes = 1) {
+      depth        = uut_depth;
+      lanes        = uut_lanes;
+      in_count     = 1;
+      out_count    = 1;
+      m_in_width   = data_i_width/uut_lanes;
+      m_out_width  = data_o_width/uut_lanes;
+      m_word_width = std::max(m_in_width, m_out_width);
+      m_in_mask    = bit_mask(m_in_width);
+      m_out_mask   = bit_mask(m_out_width);
+      m_ring.assign(uut_depth, 0);
+      m_rd       = 0;
+      m_wr       = 0;
+      m_in_bits  = 0;
+      m_out_bits = 0;
+    }
 
 
     virtual void connect_phase(uvm::uvm_phase& phase) {
@@ -96,29 +131,106 @@ public:
         out_ap.connect(out_writer.analysis_export);
     }
 
-    void write_in(wb4_seq_item* trans) {
-      wb4_seq_item* t_clone = new wb4_seq_item();
-      t_clone->do_copy(*static_cast<const wb4_seq_item*>(trans));
-      if(m_fifo.size() < depth) { 
-        m_fifo.push_front(t_clone->dat_o); // Data in to the DUT in data out of the UVC
-        this->in_to_sb_ap.write(*static_cast<const wb4_seq_item*>(t_clone)); // Dereference the pointer
+    void write_in(const wb4_seq_item& trans) {
+      if(m_wr - m_rd + in_count <= (uint64_t)depth) { 
+        // Data in to the DUT in data out of the UVC
+        for(int lane = 0; lane < in_count; ++lane)
+          push_bits((trans.dat_o >> (lane*m_in_width)) & m_in_mask, m_in_width);
+        this->in_to_sb_ap.write(trans); // Written data is expected back as is
       };
     }
 
-    void write_out(wb4_seq_item* trans) {
-      wb4_seq_item* t_clone = new wb4_seq_item();
-      t_clone->do_copy(*static_cast<const wb4_seq_item*>(trans));
-      if(!m_fifo.empty()) { 
-        t_clone->dat_i = m_fifo.back(); // Data out of the DUT in data into the UVC
-        m_fifo.pop_back(); 
-        this->out_to_sb_ap.write(*static_cast<const wb4_seq_item*>(t_clone)); // Dereference the pointer
+    void write_out(const wb4_seq_item& trans) {
+      if((m_wr - m_rd)*m_word_width - m_out_bits >= (uint64_t)(out_count*m_out_width)) { 
+        m_expected.do_copy(trans);
+        // Data out of the DUT in data into the UVC
+        uint64_t data = 0;
+        for(int lane = 0; lane < out_count; ++lane)
+          data |= pop_bits(m_out_width) << (lane*m_out_width);
+        if(lanes > 1)
+          data |= trans.dat_i & ~bit_mask(out_count*m_out_width);
+        m_expected.dat_i = data;
+        this->out_to_sb_ap.write(m_expected); // The scoreboard keeps its own copy
       };
     }
 
 
+    // The N to 1 partial word is closed with the bits written so far, the uut
+    // i_wb4_in_flush. Nothing happens without a partial word.
+    void flush() {
+      if(m_in_bits != 0) {
+        m_in_bits = 0;
+        m_wr++;
+      }
+    }
+
+
+    // The DUT dropped the k oldest words through its peek port skip.
+    void skip(int k) {
+      m_rd += std::min((uint64_t)k, m_wr - m_rd);
+    }
+
+
+    // Stream positions, bits written and bits read so far, see perf_analysis.
+    uint64_t in_position()  const { return m_wr*m_word_width + m_in_bits; }
+    uint64_t out_position() const { return m_rd*m_word_width + m_out_bits; }
+
+    // The expectation built for the last read.
+    const wb4_seq_item& expected() const { return m_expected; }
+
+
 protected:
-  //std::queue<wb4_seq_item*> m_fifo[127];
-  std::deque<uint64_t> m_fifo;
+  // Only the data words are modeled, the expected read item is rebuilt in
+  // m_expected for every read so nothing is allocated per transaction.
+  wb4_seq_item m_expected;
+  std::vector<uint64_t> m_ring;
+  uint64_t m_rd; // Free running, m_wr-m_rd words stored
+  uint64_t m_wr;
+  uint64_t m_in_mask;
+  uint64_t m_out_mask;
+  int m_in_width;
+  int m_out_width;
+  int m_word_width; // Stored word, the wider port
+  int m_in_bits;    // Bits written into the word at m_wr
+  int m_out_bits;   // Bits read from the word at m_rd
+
+  static uint64_t bit_mask(int n) {
+    return (n >= 64) ? ~0ULL : ((1ULL << n) - 1);
+  }
+
+  // Appends n bits to the stream, a word is stored once it is whole.
+  void push_bits(uint64_t data, int n) {
+    while(n > 0) {
+      int take = std::min(n, m_word_width - m_in_bits);
+      uint64_t lanes = bit_mask(take) << m_in_bits;
+      uint64_t& word = m_ring[m_wr % depth];
+      word = (word & ~lanes) | ((data << m_in_bits) & lanes);
+      data = (take >= 64) ? 0 : (data >> take);
+      n         -= take;
+      m_in_bits += take;
+      if(m_in_bits == m_word_width) {
+        m_in_bits = 0;
+        m_wr++;
+      }
+    }
+  }
+
+  // Takes n bits off the stream, a word is freed once all of it was read.
+  uint64_t pop_bits(int n) {
+    uint64_t data = 0;
+    int      got  = 0;
+    while(got < n) {
+      int take = std::min(n - got, m_word_width - m_out_bits);
+      data |= ((m_ring[m_rd % depth] >> m_out_bits) & bit_mask(take)) << got;
+      got        += take;
+      m_out_bits += take;
+      if(m_out_bits == m_word_width) {
+        m_out_bits = 0;
+        m_rd++;
+      }
+    }
+    return data;
+  }
 };
 
 #endif
@@ -114,7 +114,7 @@ SC_HAS_PROCESS(test_base);
 
 
   void report_phase(uvm::uvm_phase& phase) {
-    if(env->in_sb->error || env->out_sb->error)
+    if(env->in_sb->error || env->out_sb->error || env->tmd->errors != 0)
       test_pass = false;
     if(test_pass)
     {
@@ -22,13 +22,75 @@
 File name      : test_lib.h
 Author         : Jose R Garcia (jg-fossh@protonmail.com)
 Project Name   : Wishbone B4 FIFO Library
-Class(es) Name : test_fifo_default; test_fifo_one_wr_rd
+Class(es) Name : test_fifo_default; test_fifo_one_wr_rd; test_fifo_rd_empty;
+                 test_fifo_random; test_fifo_full_rate; test_fifo_bypass;
+                 test_fifo_peek; test_fifo_fwft; test_fifo_stats;
+                 test_fifo_level; test_fifo_1_to_N; test_fifo_N_to_1;
+                 test_fifo_lanes; test_fifo_channels; test_fifo_depth;
+                 test_fifo_rd_pipe; test_fifo_gearbox
 Description    : 
     test_fifo_default   -> test with complete code coverage.
     test_fifo_one_wr_rd -> One write followed by a read
     test_fifo_rd_empty  -> This test create two parallel operations. A read and 
                            a write starting occuring at the same time.
-    test_fifo_random    -> Randomized transactons
+    test_fifo_random    -> Randomized transactons, ACK/STALL timing checked
+                           against the timed model, traced to
+                           logs/trace.bin.
+    test_fifo_full_rate -> Back-to-back writes and reads starting from a full
+                           and from an empty FIFO, checks one ack per clock
+                           and the timed model.
+    test_fifo_bypass    -> Single words written while the reader waits on the
+                           empty FIFO, checks the read ack lands on the same
+                           clock as the write ack. Run with -GP_BYPASS=1.
+    test_fifo_peek      -> Peeks every stored word without popping it, skips
+                           some and reads the rest through the read port.
+                           Run with -GP_PEEK=1.
+    test_fifo_fwft      -> Checks the FWFT read round trip, strobe to ACK, is
+                           at least a clock shorter than the standard port and
+                           that back-to-back reads sustain one word per clock.
+                           Run with -GP_FWFT=1.
+    test_fifo_stats     -> Fills the FIFO, writes past full, empties it and
+                           reads past empty, then snapshots and clears the
+                           statistics counters over the CSR port and checks
+                           all seven. Run with -GP_STATS=1.
+    test_fifo_level     -> Fills and empties the FIFO one word at a time and
+                           checks both levels and the almost full/empty flags
+                           on every step across their thresholds. 1 to 1.
+    test_fifo_1_to_N    -> Reads a full FIFO out and streams twice its depth
+                           through it, checks the sub-words come out least
+                           significant first at one per clock, across the
+                           word boundaries. Run with -GP_DATA_I_MSB=31
+                           -GP_DATA_O_MSB=7.
+    test_fifo_N_to_1    -> Streams twice the depth in output words, checks
+                           one input word per clock and an output word every
+                           N clocks. Then a flush with the last beat of a
+                           partial word, a flush between beats and a flush
+                           with no partial word, checking the level. Run
+                           with -GP_DATA_I_MSB=7 -GP_DATA_O_MSB=31.
+    test_fifo_lanes     -> Every lane count per beat, uneven write and read
+                           counts and counts above P_LANES up to full. Checks
+                           the level, the available count and one beat per
+                           clock. Run with -GP_DATA_I_MSB=31 -GP_LANES=4.
+    test_fifo_channels  -> Writes and reads a new queue on every clock, fills
+                           one queue and writes the next one, then streams
+                           through all the queues at once. Checks the queue
+                           levels and one word per clock. The queue follows
+                           the written data and the read address. Run with
+                           -GP_CHANNELS=4.
+    test_fifo_depth     -> Non power of 2 depth. Fills to full and empties
+                           four times after skewing the pointers, so they
+                           wrap twice, and checks both levels and the
+                           full/empty stalls one word either side of the
+                           boundaries. Run with -GP_DEPTH=96.
+    test_fifo_rd_pipe   -> Fills the FIFO and reads it back to back through
+                           the read pipeline, checks one word per clock. Run
+                           with -GP_RD_PIPE_STAGES=1, then
+                           -GP_RD_PIPE_STAGES=2.
+    test_fifo_gearbox   -> Streams twice the depth through a gearbox FIFO,
+                           the words must come out in order and the narrower
+                           port must take a beat on every clock. Run with
+                           -GP_DATA_I_MSB=23 -GP_DATA_O_MSB=31, then
+                           -GP_DATA_I_MSB=9 -GP_DATA_O_MSB=7.
 Additional Comments:
  
 */
@@ -36,11 +98,17 @@ Additional Comments:
 #ifndef TEST_LIB_H_
 #define TEST_LIB_H_
 
+#include <algorithm>
 #include <ctime>
+#include <numeric>
+#include <deque>
+#include <string>
+#include <vector>
 
 #include <systemc>
 #include <uvm>
 #include "test_base.h"
+#include "../../common/ack_rate_subscriber.h"
 
 
 //--------------------------------------------------------------------------------
@@ -310,6 +378,12 @@ public:
     SC_THREAD(write_tx);
     SC_THREAD(read_tx);
   }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    uvm::uvm_config_db<int>::set(this, "env", "timed_model", 1);
+    uvm::uvm_config_db<int>::set(this, "env", "trace", 1);
+    test_base::build_phase(phase);
+  }
   
   void main_phase(uvm::uvm_phase& phase){
     UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
@@ -367,4 +441,1761 @@ public:
     }
 }; // test_fifo_random
 
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_full_rate
+//--------------------------------------------------------------------------------
+class test_fifo_full_rate : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  sc_core::sc_time  clk_period;
+  int depth;
+  int n_words; // Streamed each way, twice the depth
+
+  SC_HAS_PROCESS(test_fifo_full_rate);
+  UVM_COMPONENT_UTILS(test_fifo_full_rate);
+
+  test_fifo_full_rate( uvm::uvm_component_name name = "test_fifo_full_rate") : test_base(name){
+    test_pass  = true;
+    clk_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    uvm::uvm_config_db<int>::set(this, "env", "timed_model", 1);
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if (!uvm::uvm_config_db<int>::get(this, "*", "uut_depth", depth))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    n_words = 2*depth;
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+  
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO", uvm::UVM_LOW);
+    for(int iter = 0; iter < depth; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming from a full FIFO", uvm::UVM_LOW);
+    stream(); // The FIFO is left full
+    check_rate("full");
+
+    UVM_INFO(get_name()+"::"+__func__, ">  Emptying the FIFO", uvm::UVM_LOW);
+    for(int iter = 0; iter < depth; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming from an empty FIFO", uvm::UVM_LOW);
+    stream(); // The FIFO is left empty
+    check_rate("empty");
+
+    phase.drop_objection(this);
+  }
+
+  // Runs the writer and the reader concurrently and waits for both.
+  void stream() {
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+  }
+
+  void check_rate(const std::string& state) {
+    double in_r  = in_rate->rate(clk_period);
+    double out_r = out_rate->rate(clk_period);
+    UVM_INFO(get_name()+"::"+__func__, "> From "+state+": write acks/clk "+std::to_string(in_r)+
+      ", read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    if((int)in_rate->stamps.size() != n_words || (int)out_rate->stamps.size() != n_words || in_r < 1.0 || out_r < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Throughput from "+state+" is below one word per clock");
+      test_pass = false;
+    }
+  }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words; ++iter) {
+          write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+          write_seq->req->delay = 0;
+          write_seq->req->dat_o = iter & 0xFF;
+          write_seq->start(env->wb4_mst_in_agent->sqr);
+        }
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words; ++iter) {
+          read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+          read_seq->req->adr      = 0;
+          read_seq->req->delay    = 0;
+          read_seq->req->rsp_clks = 8;
+          read_seq->start(env->wb4_mst_out_agent->sqr);
+        }
+        read_done.notify();
+      }
+    }
+}; // test_fifo_full_rate
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_bypass
+//--------------------------------------------------------------------------------
+class test_fifo_bypass : public test_base {
+public:
+
+  static const int samples = 16;
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_event trig;
+  sc_core::sc_event read_done;
+
+  SC_HAS_PROCESS(test_fifo_bypass);
+  UVM_COMPONENT_UTILS(test_fifo_bypass);
+
+  test_fifo_bypass( uvm::uvm_component_name name = "test_fifo_bypass") : test_base(name){
+    test_pass = true;
+    SC_THREAD(read_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Single words to a waiting reader", uvm::UVM_LOW);
+    for(int iter = 0; iter < samples; ++iter) {
+      this->trig.notify(); // The reader strobes the empty FIFO first
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 2;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+      sc_core::wait(read_done);
+      sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    }
+
+    int late = 0;
+    for(int iter = 0; iter < samples && iter < (int)out_rate->stamps.size(); ++iter)
+      if(out_rate->stamps[iter] != in_rate->stamps[iter])
+        late++;
+    UVM_INFO(get_name()+"::"+__func__, "> Reads acked with their write: "+
+      std::to_string(samples-late)+" of "+std::to_string(samples), uvm::UVM_LOW);
+    if(out_rate->stamps.size() != samples || late != 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Words written to the empty FIFO were not bypassed to the reader");
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+        read_seq->req->adr      = 0;
+        read_seq->req->delay    = 0;
+        read_seq->req->rsp_clks = 8;
+        read_seq->start(env->wb4_mst_out_agent->sqr);
+        read_done.notify();
+      }
+    }
+}; // test_fifo_bypass
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_peek
+//--------------------------------------------------------------------------------
+class test_fifo_peek : public test_base {
+public:
+
+  static const int n_words = 8;
+  static const int n_skip  = 3;
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_clock* clk;
+  sc_core::sc_signal<bool>*     peek_cyc;
+  sc_core::sc_signal<bool>*     peek_stb;
+  sc_core::sc_signal<bool>*     peek_we;
+  sc_core::sc_signal<uint32_t>* peek_adr;
+  sc_core::sc_signal<bool>*     peek_ack;
+  sc_core::sc_signal<uint32_t>* peek_dat_i;
+  sc_core::sc_signal<bool>*     peek_stall;
+
+  UVM_COMPONENT_UTILS(test_fifo_peek);
+
+  test_fifo_peek( uvm::uvm_component_name name = "test_fifo_peek") : test_base(name){
+    test_pass = true;
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_clock*>::get(this, "*", "sim_clk", clk) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_peek_cyc", peek_cyc) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_peek_stb", peek_stb) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_peek_we", peek_we) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_peek_adr", peek_adr) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_peek_ack", peek_ack) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_peek_dat_i", peek_dat_i) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_peek_stall", peek_stall))
+      UVM_FATAL("NOSIG", "Peek port signals must be set for: " + get_full_name());
+  }
+
+  // One classic cycle on the peek port, returns the data on the ack.
+  uint32_t peek_cycle(bool skip, uint32_t k) {
+    bool accepted = false;
+    sc_core::wait(clk->negedge_event());
+    peek_cyc->write(true);
+    peek_stb->write(true);
+    peek_we->write(skip);
+    peek_adr->write(k);
+    while(!accepted) {
+      sc_core::wait(sc_core::sc_time(1.0, sc_core::SC_NS)); // STALL settles
+      accepted = !peek_stall->read();
+      sc_core::wait(clk->negedge_event());
+    }
+    peek_stb->write(false);
+    uint32_t data = peek_dat_i->read();
+    if(!peek_ack->read()) {
+      UVM_ERROR(get_name()+"::"+__func__, "Peek port strobe not acked on the next clock");
+      test_pass = false;
+    }
+    peek_cyc->write(false);
+    return data;
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Writing "+std::to_string(n_words)+" words", uvm::UVM_LOW);
+    for(int iter = 0; iter < n_words; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter+1;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+
+    UVM_INFO(get_name()+"::"+__func__, "> Peeking every entry twice", uvm::UVM_LOW);
+    for(int pass = 0; pass < 2; ++pass) {
+      for(int k = 0; k < n_words; ++k) {
+        uint32_t data = peek_cycle(false, k);
+        if(data != (uint32_t)(k+1)) {
+          UVM_ERROR(get_name()+"::"+__func__, "Peek at head+"+std::to_string(k)+
+            " returned "+std::to_string(data)+", expected "+std::to_string(k+1));
+          test_pass = false;
+        }
+      }
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Skipping "+std::to_string(n_skip)+" words", uvm::UVM_LOW);
+    peek_cycle(true, n_skip);
+    env->prd->skip(n_skip);
+
+    // The scoreboard checks the words left start after the skipped ones.
+    UVM_INFO(get_name()+"::"+__func__, ">  Reading the rest", uvm::UVM_LOW);
+    for(int iter = n_skip; iter < n_words; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_peek
+
+//--------------------------------------------------------------------------------
+// test_fifo_fwft
+//--------------------------------------------------------------------------------
+class test_fifo_fwft : public test_base {
+public:
+
+  static const int n_single = 16;
+  static const int n_words  = 64;
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* out_rate;
+  wb4_bfm* out_vif;
+  int uut_fwft;
+  int uut_use_bram;
+  int max_rd_lat; // Clocks from an accepted read strobe to its ACK
+  std::deque<uint64_t> rd_accepts;
+  sc_core::sc_time clk_period;
+
+  SC_HAS_PROCESS(test_fifo_fwft);
+  UVM_COMPONENT_UTILS(test_fifo_fwft);
+
+  test_fifo_fwft( uvm::uvm_component_name name = "test_fifo_fwft") : test_base(name){
+    test_pass  = true;
+    max_rd_lat = 0;
+    clk_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    SC_THREAD(read_latency);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    uvm::uvm_config_db<int>::set(this, "env", "timed_model", 1);
+    test_base::build_phase(phase);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if (!uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_out_if", out_vif) ||
+        !uvm::uvm_config_db<int>::get(this, "*", "uut_fwft", uut_fwft) ||
+        !uvm::uvm_config_db<int>::get(this, "*", "uut_use_bram", uut_use_bram))
+      UVM_FATAL("NOCFG", "Read port interface and parameters must be set for: " + get_full_name());
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(uut_fwft != 1) {
+      UVM_ERROR(get_name()+"::"+__func__, "The uut is not a FWFT build, run with -GP_FWFT=1");
+      test_pass = false;
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Single reads of a stored word", uvm::UVM_LOW);
+    for(int iter = 0; iter < n_single; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+      sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+      sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    }
+
+    // The standard port registers the memory output, BRAM adds its own.
+    int std_lat = (uut_use_bram == 1) ? 2 : 1;
+    UVM_INFO(get_name()+"::"+__func__, "> Read round trip "+std::to_string(max_rd_lat)+
+      " clocks, the standard port takes "+std::to_string(std_lat), uvm::UVM_LOW);
+    if(max_rd_lat > std_lat-1) {
+      UVM_ERROR(get_name()+"::"+__func__, "FWFT read round trip is not shorter than the standard port");
+      test_pass = false;
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO", uvm::UVM_LOW);
+    for(int iter = 0; iter < n_words; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+
+    UVM_INFO(get_name()+"::"+__func__, ">  Back-to-back reads", uvm::UVM_LOW);
+    out_rate->stamps.clear();
+    for(int iter = 0; iter < n_words; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+
+    double out_r = out_rate->rate(clk_period);
+    UVM_INFO(get_name()+"::"+__func__, "> Read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    if(out_rate->stamps.size() != n_words || out_r < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Back-to-back FWFT reads are below one word per clock");
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block, matches every read ACK to its strobe.
+    void read_latency() {
+      uint64_t cycle = 0;
+      while(true) {
+        sc_core::wait(out_vif->clk_i.posedge_event());
+        cycle++;
+        if(out_vif->cyc.read() && out_vif->stb.read() && !out_vif->stall.read())
+          rd_accepts.push_back(cycle);
+        if(out_vif->ack.read() && !rd_accepts.empty()) {
+          max_rd_lat = std::max(max_rd_lat, (int)(cycle - rd_accepts.front()));
+          rd_accepts.pop_front();
+        }
+      }
+    }
+}; // test_fifo_fwft
+
+//--------------------------------------------------------------------------------
+// test_fifo_stats
+//--------------------------------------------------------------------------------
+class test_fifo_stats : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_clock*            csr_clk;
+  sc_core::sc_signal<bool>*     csr_cyc;
+  sc_core::sc_signal<bool>*     csr_stb;
+  sc_core::sc_signal<bool>*     csr_we;
+  sc_core::sc_signal<bool>*     csr_ack;
+  sc_core::sc_signal<uint32_t>* csr_adr;
+  sc_core::sc_signal<uint32_t>* csr_dat_o;
+  sc_core::sc_signal<uint32_t>* csr_dat_i;
+  sc_core::sc_event release_trig; // One read frees the write stalled on full
+  sc_core::sc_event refill_trig;  // One write ends the read stalled on empty
+  sc_core::sc_time  hold;         // How long the other side is kept stalled
+  sc_core::sc_time  wr_period;
+  sc_core::sc_time  rd_period;
+  sc_core::sc_time  settle;
+  int slack;   // Clocks a stall may outlast hold, the flags crossing back
+  int depth;
+  int next_wr; // Value of the next word written, counts up
+
+  SC_HAS_PROCESS(test_fifo_stats);
+  UVM_COMPONENT_UTILS(test_fifo_stats);
+
+  test_fifo_stats( uvm::uvm_component_name name = "test_fifo_stats") : test_base(name){
+    test_pass = true;
+    hold      = sc_core::sc_time(200.0, sc_core::SC_NS);
+    wr_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    rd_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    settle    = sc_core::sc_time(50.0, sc_core::SC_NS);
+    slack     = 6;
+    next_wr   = 0;
+    SC_THREAD(release_tx);
+    SC_THREAD(refill_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_clock*>::get(this, "*", "csr_clk", csr_clk) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_cyc", csr_cyc) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_stb", csr_stb) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_we", csr_we) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "csr_ack", csr_ack) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "csr_adr", csr_adr) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "csr_dat_o", csr_dat_o) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "csr_dat_i", csr_dat_i))
+      UVM_FATAL("NOSIG", "Statistics CSR port must be set for: " + get_full_name());
+    if (!uvm::uvm_config_db<int>::get(this, "*", "uut_depth", depth))
+      UVM_FATAL("NOCFG", "UUT depth must be set for: " + get_full_name());
+  }
+
+  void write_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = next_wr++;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+  }
+
+  void read_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+  }
+
+  // One single beat CSR cycle, returns the read data.
+  uint32_t csr_access(bool we, uint32_t adr, uint32_t dat) {
+    sc_core::wait(csr_clk->posedge_event());
+    csr_cyc->write(true);
+    csr_stb->write(true);
+    csr_we->write(we);
+    csr_adr->write(adr);
+    csr_dat_o->write(dat);
+    sc_core::wait(csr_clk->posedge_event());
+    csr_stb->write(false);
+    while(!csr_ack->read())
+      sc_core::wait(csr_clk->posedge_event());
+    uint32_t rdata = csr_dat_i->read();
+    csr_cyc->write(false);
+    csr_we->write(false);
+    return rdata;
+  }
+
+  // Snapshot and/or clear, then wait for the read side to catch up.
+  void csr_command(uint32_t cmd) {
+    csr_access(true, 0, cmd);
+    while(csr_access(false, 0, 0) & 1) {}
+  }
+
+  void check_counter(uint32_t adr, std::string name, uint32_t lo, uint32_t hi) {
+    uint32_t count = csr_access(false, adr, 0);
+    std::string expected = std::to_string(lo);
+    if(hi != lo)
+      expected += " to "+std::to_string(hi);
+    if(count < lo || count > hi) {
+      UVM_ERROR(get_name()+"::"+__func__, name+": "+std::to_string(count)+", expected: "+expected);
+      test_pass = false;
+    }
+    else
+      UVM_INFO(get_name()+"::"+__func__, name+": "+std::to_string(count), uvm::UVM_LOW);
+  }
+
+  void check_counter(uint32_t adr, std::string name, uint32_t expected) {
+    check_counter(adr, name, expected, expected);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    // Both stalls start with the strobe and end once the helper's word
+    // crossed, so each one lasts hold give or take a clock, plus the slack.
+    const uint32_t wr_stalls = hold/wr_period;
+    const uint32_t rd_stalls = hold/rd_period;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO", uvm::UVM_LOW);
+    write_words(depth);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Writing past full, a read frees it later", uvm::UVM_LOW);
+    release_trig.notify();
+    write_words(1);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Emptying the FIFO", uvm::UVM_LOW);
+    read_words(depth);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Reading past empty, a write ends it later", uvm::UVM_LOW);
+    refill_trig.notify();
+    read_words(1);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Snapshot and clear", uvm::UVM_LOW);
+    csr_command(3);
+    check_counter(1, "WRITES", depth+2);
+    check_counter(2, "READS", depth+2);
+    check_counter(3, "WR_STALLS", wr_stalls-1, wr_stalls+slack);
+    check_counter(4, "RD_STALLS", rd_stalls-1, rd_stalls+slack);
+    check_counter(5, "HIGH_WATER", depth);
+    check_counter(6, "OVERFLOWS", 1);
+    check_counter(7, "UNDERFLOWS", 1);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Snapshot after the clear", uvm::UVM_LOW);
+    csr_command(1);
+    for(uint32_t adr = 1; adr < 8; ++adr)
+      check_counter(adr, "Counter "+std::to_string(adr), 0);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(settle);
+
+    phase.drop_objection(this);
+  }
+
+  // Reads one word hold after the write into the full FIFO started.
+  void release_tx() {
+    while(true) {
+      sc_core::wait(release_trig);
+      sc_core::wait(hold);
+      read_words(1);
+    }
+  }
+
+  // Writes one word hold after the read from the empty FIFO started.
+  void refill_tx() {
+    while(true) {
+      sc_core::wait(refill_trig);
+      sc_core::wait(hold);
+      write_words(1);
+    }
+  }
+}; // test_fifo_stats
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_level
+//--------------------------------------------------------------------------------
+class test_fifo_level : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_signal<uint32_t>* in_level;
+  sc_core::sc_signal<uint32_t>* out_level;
+  sc_core::sc_signal<bool>*     in_almost_full;
+  sc_core::sc_signal<bool>*     out_almost_empty;
+  sc_core::sc_signal<uint32_t>* in_afull_thresh;
+  sc_core::sc_signal<uint32_t>* out_aempty_thresh;
+  int afull;  // Almost Full when level >= afull
+  int aempty; // Almost Empty when level <= aempty
+
+  UVM_COMPONENT_UTILS(test_fifo_level);
+
+  test_fifo_level( uvm::uvm_component_name name = "test_fifo_level") : test_base(name){
+    test_pass = true;
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_level", out_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_almost_full", in_almost_full) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_out_almost_empty", out_almost_empty) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_afull_thresh", in_afull_thresh) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_aempty_thresh", out_aempty_thresh))
+      UVM_FATAL("NOSIG", "Fill level side band must be set for: " + get_full_name());
+  }
+
+  // Both sides must agree on the level once the FIFO settled, the flags must
+  // flip exactly at their thresholds.
+  void check_level(int words) {
+    sc_core::wait(sc_core::sc_time(20.0, sc_core::SC_NS));
+    int in_l  = in_level->read();
+    int out_l = out_level->read();
+    if(in_l != words || out_l != words ||
+       in_almost_full->read() != (words >= afull) ||
+       out_almost_empty->read() != (words <= aempty)) {
+      UVM_ERROR(get_name()+"::"+__func__, "With "+std::to_string(words)+" words stored, levels: "+
+        std::to_string(in_l)+"/"+std::to_string(out_l)+", almost full: "+
+        std::to_string(in_almost_full->read())+", almost empty: "+std::to_string(out_almost_empty->read()));
+      test_pass = false;
+    }
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    // Same as the P_ALMOST_FULL/P_ALMOST_EMPTY defaults, so the test holds
+    // with and without P_PROG_THRESH=1.
+    afull  = (env->prd->depth*3)/4;
+    aempty = env->prd->depth/4;
+    in_afull_thresh->write(afull);
+    out_aempty_thresh->write(aempty);
+    check_level(0);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling one word at a time", uvm::UVM_LOW);
+    for(int iter = 0; iter < env->prd->depth; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+      check_level(iter+1);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, ">  Emptying one word at a time", uvm::UVM_LOW);
+    for(int iter = env->prd->depth; iter > 0; --iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+      check_level(iter-1);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_level
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_1_to_N
+//--------------------------------------------------------------------------------
+class test_fifo_1_to_N : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  sc_core::sc_time  out_period;
+  int data_i_width;
+  int data_o_width;
+  int lanes;   // Sub-words per input word
+  int n_words; // Input words streamed by write_tx
+
+  SC_HAS_PROCESS(test_fifo_1_to_N);
+  UVM_COMPONENT_UTILS(test_fifo_1_to_N);
+
+  test_fifo_1_to_N( uvm::uvm_component_name name = "test_fifo_1_to_N") : test_base(name){
+    test_pass  = true;
+    out_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_data_i_width", data_i_width) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_o_width", data_o_width))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    lanes = (data_o_width < data_i_width) ? data_i_width/data_o_width : 1;
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  // Sub-word j of input word k counts up, k*lanes+j, least significant first.
+  uint32_t word(int k) {
+    uint64_t data = 0;
+    uint64_t mask = (1ULL << data_o_width) - 1;
+    for(int j = 0; j < lanes; ++j)
+      data |= ((uint64_t)(k*lanes+j) & mask) << (j*data_o_width);
+    return (uint32_t)data;
+  }
+
+  // The sub-words must come out back-to-back, across the word boundaries too.
+  void check_rate(const std::string& what, int sub_words) {
+    double out_r = out_rate->rate(out_period);
+    UVM_INFO(get_name()+"::"+__func__, "> "+what+": read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    if((int)out_rate->stamps.size() != sub_words || out_r < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, what+": "+std::to_string(out_rate->stamps.size())+" of "+
+        std::to_string(sub_words)+" sub-words read, below one per clock");
+      test_pass = false;
+    }
+    out_rate->stamps.clear();
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(data_i_width <= data_o_width || (data_i_width % data_o_width) != 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not a 1 to N FIFO, run with -GP_DATA_I_MSB=31 -GP_DATA_O_MSB=7");
+      test_pass = false;
+    }
+    const int depth = env->prd->depth;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO with "+std::to_string(depth)+" words", uvm::UVM_LOW);
+    for(int iter = 0; iter < depth; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = word(iter);
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    out_rate->stamps.clear();
+
+    UVM_INFO(get_name()+"::"+__func__, "> Reading the full FIFO out", uvm::UVM_LOW);
+    for(int iter = 0; iter < depth*lanes; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check_rate("From full", depth*lanes);
+
+    // Writes run ahead until the FIFO is full, then wait on the reader, the
+    // pointers wrap twice.
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming from an empty FIFO", uvm::UVM_LOW);
+    n_words = 2*depth;
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check_rate("Streaming", n_words*lanes);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words; ++iter) {
+          write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+          write_seq->req->delay = 0;
+          write_seq->req->dat_o = word(iter);
+          write_seq->start(env->wb4_mst_in_agent->sqr);
+        }
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_words*lanes; ++iter) {
+          read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+          read_seq->req->adr      = 0;
+          read_seq->req->delay    = 0;
+          read_seq->req->rsp_clks = 8;
+          read_seq->start(env->wb4_mst_out_agent->sqr);
+        }
+        read_done.notify();
+      }
+    }
+}; // test_fifo_1_to_N
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_N_to_1
+//--------------------------------------------------------------------------------
+class test_fifo_N_to_1 : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_clock*            sim_clk;
+  sc_core::sc_signal<bool>*     in_flush;
+  sc_core::sc_signal<uint32_t>* in_level;
+  wb4_bfm* in_vif;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  sc_core::sc_event flush_trig;
+  sc_core::sc_time  clk_period;
+  int data_i_width;
+  int data_o_width;
+  int lanes;      // Input words per output word
+  int n_words;    // Input words streamed by write_tx
+  int flush_beat; // Input word flush_tx raises the flush with
+  int next_wr;    // Value of the next input word, counts up
+
+  SC_HAS_PROCESS(test_fifo_N_to_1);
+  UVM_COMPONENT_UTILS(test_fifo_N_to_1);
+
+  test_fifo_N_to_1( uvm::uvm_component_name name = "test_fifo_N_to_1") : test_base(name){
+    test_pass  = true;
+    clk_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    next_wr    = 0;
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+    SC_THREAD(flush_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_data_i_width", data_i_width) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_o_width", data_o_width))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    if (!uvm::uvm_config_db<sc_core::sc_clock*>::get(this, "*", "sim_clk", sim_clk) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<bool>*>::get(this, "*", "wb4_in_flush", in_flush) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level))
+      UVM_FATAL("NOSIG", "Flush and fill level ports must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_in_if", in_vif))
+      UVM_FATAL("NOVIF", "Virtual interface must be set for: " + get_full_name());
+    lanes = (data_o_width > data_i_width) ? data_o_width/data_i_width : 1;
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void write_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = next_wr++;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+  }
+
+  void read_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+  }
+
+  // A one clock flush with no write strobe.
+  void pulse_flush() {
+    sc_core::wait(sim_clk->posedge_event());
+    in_flush->write(true);
+    sc_core::wait(sim_clk->posedge_event());
+    in_flush->write(false);
+  }
+
+  void check_level(const std::string& what, uint32_t expected) {
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    if(in_level->read() != expected) {
+      UVM_ERROR(get_name()+"::"+__func__, what+": level "+std::to_string(in_level->read())+
+        ", expected: "+std::to_string(expected));
+      test_pass = false;
+    }
+  }
+
+  // One input word per clock and, past the first output word, one output
+  // word every lanes clocks with no bubble between them.
+  void check_rate() {
+    double in_r = in_rate->rate(clk_period);
+    sc_core::sc_time gap = sc_core::SC_ZERO_TIME;
+    for(size_t k = 1; k < out_rate->stamps.size(); ++k)
+      gap = std::max(gap, out_rate->stamps[k] - out_rate->stamps[k-1]);
+    UVM_INFO(get_name()+"::"+__func__, "> Write acks/clk "+std::to_string(in_r)+", widest read gap "+
+      gap.to_string(), uvm::UVM_LOW);
+    if((int)in_rate->stamps.size() != n_words || (int)out_rate->stamps.size() != n_words/lanes ||
+       in_r < 1.0 || gap > lanes*clk_period) {
+      UVM_ERROR(get_name()+"::"+__func__, "Packing is below one output word every "+std::to_string(lanes)+" clocks");
+      test_pass = false;
+    }
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(data_o_width <= data_i_width || (data_o_width % data_i_width) != 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not an N to 1 FIFO, run with -GP_DATA_I_MSB=7 -GP_DATA_O_MSB=31");
+      test_pass = false;
+    }
+    const int depth = env->prd->depth;
+
+    // The pointers wrap twice.
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming "+std::to_string(2*depth)+" output words", uvm::UVM_LOW);
+    n_words = 2*depth*lanes;
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check_rate();
+
+    // The flush comes with the last beat of a partial word, both go into it.
+    UVM_INFO(get_name()+"::"+__func__, "> Flush in the same clock as a beat", uvm::UVM_LOW);
+    flush_beat = 2*lanes-2;
+    this->flush_trig.notify();
+    write_words(2*lanes-1);
+    env->prd->flush();
+    check_level("Flush with a beat", 2);
+    read_words(2);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Flush between beats", uvm::UVM_LOW);
+    write_words(lanes-1);
+    pulse_flush();
+    env->prd->flush();
+    check_level("Flush between beats", 1);
+    read_words(1);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Flush with no partial word", uvm::UVM_LOW);
+    write_words(lanes);
+    pulse_flush();
+    env->prd->flush();
+    check_level("Flush after a whole word", 1);
+    read_words(1);
+    pulse_flush();
+    env->prd->flush();
+    check_level("Flush on empty", 0);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        write_words(n_words);
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        read_words(n_words/lanes);
+        read_done.notify();
+      }
+    }
+
+    // Raises the flush for the clock write beat flush_beat (2 or more) is
+    // taken on. Beats go in one per clock and are acked the clock after, an
+    // ack seen on a clock edge is the beat taken on the edge before.
+    void flush_tx() {
+      while(true) {
+        wait(flush_trig); // Wait for the event to be triggered
+        int acks = 0;
+        while(acks < flush_beat-1) {
+          sc_core::wait(sim_clk->posedge_event());
+          if(in_vif->ack.read())
+            acks++;
+        }
+        in_flush->write(true);
+        sc_core::wait(sim_clk->posedge_event());
+        in_flush->write(false);
+      }
+    }
+}; // test_fifo_N_to_1
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_lanes
+//--------------------------------------------------------------------------------
+class test_fifo_lanes : public test_base {
+public:
+
+  static const int n_beats = 16;
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_signal<uint32_t>* in_count;
+  sc_core::sc_signal<uint32_t>* out_count;
+  sc_core::sc_signal<uint32_t>* out_avail;
+  sc_core::sc_signal<uint32_t>* in_level;
+  sc_core::sc_time clk_period;
+  int lanes;
+  int lane_width;
+  int next_word; // Value of the next word written, counts up
+
+  UVM_COMPONENT_UTILS(test_fifo_lanes);
+
+  test_fifo_lanes( uvm::uvm_component_name name = "test_fifo_lanes") : test_base(name){
+    test_pass  = true;
+    clk_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    next_word  = 0;
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    int data_i_width;
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_lanes", lanes) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_i_width", data_i_width))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    lane_width = data_i_width/lanes;
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_count", in_count) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_count", out_count) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_avail", out_avail) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level))
+      UVM_FATAL("NOSIG", "Lane count side band must be set for: " + get_full_name());
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  // Counts driven on the ports and the words the predictor moves per beat,
+  // a count above P_LANES is taken as P_LANES.
+  void set_counts(int wr, int rd) {
+    in_count->write(wr);
+    out_count->write(rd);
+    env->prd->in_count  = std::min(wr, lanes);
+    env->prd->out_count = std::min(rd, lanes);
+  }
+
+  void write_beats(int n) {
+    uint64_t mask = (1ULL << lane_width) - 1;
+    for(int iter = 0; iter < n; ++iter) {
+      uint64_t data = 0;
+      for(int lane = 0; lane < env->prd->in_count; ++lane)
+        data |= ((uint64_t)(next_word++) & mask) << (lane*lane_width);
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = (uint32_t)data;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+  }
+
+  void read_beats(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+  }
+
+  void check(const std::string& what, bool ok) {
+    if(!ok) {
+      UVM_ERROR(get_name()+"::"+__func__, what+", level: "+std::to_string(in_level->read())+
+        ", avail: "+std::to_string(out_avail->read()));
+      test_pass = false;
+    }
+  }
+
+  // Every beat, whatever its count, must be acked on its own clock.
+  void check_rate(const std::string& what, int wr_beats, int rd_beats) {
+    double in_r  = in_rate->rate(clk_period);
+    double out_r = out_rate->rate(clk_period);
+    UVM_INFO(get_name()+"::"+__func__, "> "+what+": write acks/clk "+std::to_string(in_r)+
+      ", read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    check(what+" beats not acked on every clock",
+          (int)in_rate->stamps.size() == wr_beats && (int)out_rate->stamps.size() == rd_beats &&
+          (wr_beats < 2 || in_r >= 1.0) && (rd_beats < 2 || out_r >= 1.0));
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(lanes < 2) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not a multi lane FIFO, run with -GP_DATA_I_MSB=31 -GP_LANES=4");
+      test_pass = false;
+    }
+    const int depth = env->prd->depth;
+
+    for(int count = 1; count <= lanes; ++count) {
+      UVM_INFO(get_name()+"::"+__func__, "> "+std::to_string(count)+" words per beat", uvm::UVM_LOW);
+      set_counts(count, count);
+      write_beats(n_beats);
+      sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+      check("After "+std::to_string(n_beats)+" beats of "+std::to_string(count),
+            (int)in_level->read() == n_beats*count && (int)out_avail->read() == lanes);
+      read_beats(n_beats);
+      sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+      check("Not empty after reading it all", in_level->read() == 0 && out_avail->read() == 0);
+      check_rate(std::to_string(count)+" words per beat", n_beats, n_beats);
+    }
+
+    // Fewer words stored than lanes, avail follows the level.
+    UVM_INFO(get_name()+"::"+__func__, "> Uneven write and read counts", uvm::UVM_LOW);
+    set_counts(lanes-1, 2);
+    write_beats(2);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Partial lanes available", (int)out_avail->read() == std::min(2*(lanes-1), lanes));
+    read_beats(lanes-1);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Not empty after uneven beats", in_level->read() == 0);
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+
+    // Counts past P_LANES move P_LANES words, the FIFO fills up exactly.
+    UVM_INFO(get_name()+"::"+__func__, "> Counts above P_LANES, to full", uvm::UVM_LOW);
+    set_counts(2*lanes-1, 2*lanes-1);
+    write_beats(depth/lanes);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Not full after "+std::to_string(depth/lanes)+" clamped beats", (int)in_level->read() == depth);
+    read_beats(depth/lanes);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Not empty after the clamped beats", in_level->read() == 0);
+    check_rate("Clamped counts", depth/lanes, depth/lanes);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_lanes
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_channels
+//--------------------------------------------------------------------------------
+class test_fifo_channels : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_signal<uint32_t>* in_chan;
+  sc_core::sc_signal<uint32_t>* out_chan;
+  sc_core::sc_signal<uint32_t>* in_level;
+  sc_core::sc_signal<uint32_t>* out_level;
+  wb4_bfm* in_vif;
+  wb4_bfm* out_vif;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  sc_core::sc_time  clk_period;
+  int channels;
+  int n_words; // Words streamed by write_tx/read_tx
+
+  SC_HAS_PROCESS(test_fifo_channels);
+  UVM_COMPONENT_UTILS(test_fifo_channels);
+
+  test_fifo_channels( uvm::uvm_component_name name = "test_fifo_channels") : test_base(name){
+    test_pass  = true;
+    clk_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    n_words    = 0;
+    SC_THREAD(chan_tx);
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_channels", channels))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_chan", in_chan) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_chan", out_chan) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_level", out_level))
+      UVM_FATAL("NOSIG", "Channel side band must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_in_if", in_vif) ||
+       ! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_out_if", out_vif))
+      UVM_FATAL("NOVIF", "Virtual interfaces must be set for: " + get_full_name());
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void write_words(int first, int n, int step) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = (first + iter*step) & 0xFF;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+  }
+
+  void read_words(int first, int n, int step) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = (first + iter*step) % channels;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+  }
+
+  void check(const std::string& what, bool ok) {
+    if(!ok) {
+      UVM_ERROR(get_name()+"::"+__func__, what+", write queue level: "+std::to_string(in_level->read())+
+        ", read queue level: "+std::to_string(out_level->read()));
+      test_pass = false;
+    }
+  }
+
+  void check_rate(const std::string& what, int n) {
+    double in_r  = in_rate->rate(clk_period);
+    double out_r = out_rate->rate(clk_period);
+    UVM_INFO(get_name()+"::"+__func__, "> "+what+": write acks/clk "+std::to_string(in_r)+
+      ", read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    check(what+" below one word per clock",
+          (int)in_rate->stamps.size() == n && (int)out_rate->stamps.size() == n && in_r >= 1.0 && out_r >= 1.0);
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(channels < 2) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not a multi queue FIFO, run with -GP_CHANNELS=4");
+      test_pass = false;
+      channels = 1;
+    }
+    const int ch_depth = env->prd->depth/channels;
+
+    // Every beat goes to the next queue, a round puts one word in each.
+    const int rounds = std::min(ch_depth, 8);
+    UVM_INFO(get_name()+"::"+__func__, "> Writing then reading a new queue every clock", uvm::UVM_LOW);
+    write_words(0, rounds*channels, 1);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Queue level after "+std::to_string(rounds)+" rounds", (int)in_level->read() == rounds);
+    read_words(0, rounds*channels, 1);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Queue not empty after the rounds", in_level->read() == 0 && out_level->read() == 0);
+    check_rate("Interleaved", rounds*channels);
+
+    // A full queue stalls its own beats only.
+    UVM_INFO(get_name()+"::"+__func__, "> Filling queue 0, then writing queue 1", uvm::UVM_LOW);
+    write_words(0, ch_depth, channels);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Queue 0 not full", (int)in_level->read() == ch_depth && in_vif->stall.read());
+    write_words(1, 1, 0);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Queue 1 write not taken next to a full queue 0", in_level->read() == 1);
+    read_words(0, ch_depth, channels);
+    read_words(1, 1, 0);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check("Queues not empty", in_level->read() == 0 && out_level->read() == 0);
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+
+    // Writer and reader together, the reader waits on the queue it is on.
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming through all the queues", uvm::UVM_LOW);
+    n_words = 2*env->prd->depth;
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+    check_rate("Streaming", n_words);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+
+    // The queue follows the beat, the written data and the read address.
+    void chan_tx() {
+      while(true) {
+        sc_core::wait(in_vif->dat_o.value_changed_event() | out_vif->adr.value_changed_event());
+        in_chan->write(in_vif->dat_o.read() % channels);
+        out_chan->write(out_vif->adr.read() % channels);
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        write_words(0, n_words, 1);
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        read_words(0, n_words, 1);
+        read_done.notify();
+      }
+    }
+}; // test_fifo_channels
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_depth
+//--------------------------------------------------------------------------------
+class test_fifo_depth : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  sc_core::sc_signal<uint32_t>* in_level;
+  sc_core::sc_signal<uint32_t>* out_level;
+  wb4_bfm* in_vif;
+  wb4_bfm* out_vif;
+  sc_core::sc_time settle;
+  int next_wr; // Value of the next word written, counts up
+
+  UVM_COMPONENT_UTILS(test_fifo_depth);
+
+  test_fifo_depth( uvm::uvm_component_name name = "test_fifo_depth") : test_base(name){
+    test_pass = true;
+    settle    = sc_core::sc_time(50.0, sc_core::SC_NS);
+    next_wr   = 0;
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_in_level", in_level) ||
+        !uvm::uvm_config_db<sc_core::sc_signal<uint32_t>*>::get(this, "*", "wb4_out_level", out_level))
+      UVM_FATAL("NOSIG", "Fill level ports must be set for: " + get_full_name());
+    if(! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_in_if", in_vif) ||
+       ! uvm::uvm_config_db<wb4_bfm*>::get(this, "*", "wb4_mst_out_if", out_vif))
+      UVM_FATAL("NOVIF", "Virtual interfaces must be set for: " + get_full_name());
+  }
+
+  void write_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = (next_wr++) & 0xFF;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+    sc_core::wait(settle);
+  }
+
+  void read_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+    sc_core::wait(settle);
+  }
+
+  // Both levels and the full/empty stalls once the FIFO settled at level.
+  void check_level(const std::string& what, int level) {
+    const int depth = env->prd->depth;
+    bool ok = (int)in_level->read() == level && (int)out_level->read() == level &&
+              in_vif->stall.read() == (level == depth) && out_vif->stall.read() == (level == 0);
+    if(!ok) {
+      UVM_ERROR(get_name()+"::"+__func__, what+": expected level "+std::to_string(level)+
+        ", write level "+std::to_string(in_level->read())+" stall "+std::to_string(in_vif->stall.read())+
+        ", read level "+std::to_string(out_level->read())+" stall "+std::to_string(out_vif->stall.read()));
+      test_pass = false;
+    }
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    const int depth = env->prd->depth;
+    if((depth & (depth-1)) == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "P_DEPTH="+std::to_string(depth)+" is a power of 2, run with -GP_DEPTH=96");
+      test_pass = false;
+    }
+
+    // Skew the pointers so full falls in the middle of the memory.
+    UVM_INFO(get_name()+"::"+__func__, "> Moving the pointers off 0", uvm::UVM_LOW);
+    write_words(depth/3);
+    read_words(depth/3);
+    check_level("Offset", 0);
+
+    // The pointers count to 2*P_DEPTH, 4*P_DEPTH words wrap them twice.
+    for(int round = 0; round < 4; ++round) {
+      UVM_INFO(get_name()+"::"+__func__, "> Round "+std::to_string(round)+", to full and back", uvm::UVM_LOW);
+      write_words(depth-1);
+      check_level("One word short of full", depth-1);
+      write_words(1);
+      check_level("Full", depth);
+      read_words(1);
+      check_level("One word out of full", depth-1);
+      write_words(1);
+      check_level("Full again", depth);
+      read_words(depth-1);
+      check_level("One word left", 1);
+      read_words(1);
+      check_level("Empty", 0);
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Allowing TB to settle", uvm::UVM_LOW);
+    sc_core::wait(sc_core::sc_time(150.0, sc_core::SC_NS));
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_depth
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_rd_pipe
+//--------------------------------------------------------------------------------
+class test_fifo_rd_pipe : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_time rd_period;
+  sc_core::sc_time settle;
+  int depth;
+  int stages;
+
+  UVM_COMPONENT_UTILS(test_fifo_rd_pipe);
+
+  test_fifo_rd_pipe( uvm::uvm_component_name name = "test_fifo_rd_pipe") : test_base(name){
+    test_pass = true;
+    rd_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    settle    = sc_core::sc_time(50.0, sc_core::SC_NS);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    if (!uvm::uvm_config_db<int>::get(this, "*", "uut_depth", depth) ||
+        !uvm::uvm_config_db<int>::get(this, "*", "uut_rd_pipe_stages", stages))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void write_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+      write_seq->req->delay = 0;
+      write_seq->req->dat_o = iter;
+      write_seq->start(env->wb4_mst_in_agent->sqr);
+    }
+  }
+
+  void read_words(int n) {
+    for(int iter = 0; iter < n; ++iter) {
+      read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+      read_seq->req->adr      = 0;
+      read_seq->req->delay    = 0;
+      read_seq->req->rsp_clks = 8;
+      read_seq->start(env->wb4_mst_out_agent->sqr);
+    }
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if(stages == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "The read pipeline is off, P_RD_PIPE_STAGES is 0");
+      test_pass = false;
+    }
+
+    UVM_INFO(get_name()+"::"+__func__, "> Filling the FIFO", uvm::UVM_LOW);
+    write_words(depth);
+    sc_core::wait(settle);
+
+    UVM_INFO(get_name()+"::"+__func__, "> Reading it back to back through "+std::to_string(stages)+" stages", uvm::UVM_LOW);
+    out_rate->stamps.clear();
+    read_words(depth);
+    sc_core::wait(settle);
+
+    double out_r = out_rate->rate(rd_period);
+    UVM_INFO(get_name()+"::"+__func__, "> Read acks/clk "+std::to_string(out_r), uvm::UVM_LOW);
+    if(out_rate->stamps.size() != static_cast<size_t>(depth) || out_r < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Sustained read through the pipeline is below one word per clock");
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+}; // test_fifo_rd_pipe
+
+
+
+//--------------------------------------------------------------------------------
+// test_fifo_gearbox
+//--------------------------------------------------------------------------------
+class test_fifo_gearbox : public test_base {
+public:
+
+  wb4_wr_request_seq* write_seq;
+  wb4_rd_request_seq* read_seq;
+  ack_rate_subscriber* in_rate;
+  ack_rate_subscriber* out_rate;
+  sc_core::sc_event trig;
+  sc_core::sc_event write_done;
+  sc_core::sc_event read_done;
+  sc_core::sc_time  in_period;
+  sc_core::sc_time  out_period;
+  int data_i_width;
+  int data_o_width;
+  int n_in;  // Input words streamed by write_tx
+  int n_out; // Output words read by read_tx, the same bits
+
+  SC_HAS_PROCESS(test_fifo_gearbox);
+  UVM_COMPONENT_UTILS(test_fifo_gearbox);
+
+  test_fifo_gearbox( uvm::uvm_component_name name = "test_fifo_gearbox") : test_base(name){
+    test_pass  = true;
+    in_period  = sc_core::sc_time(5.0, sc_core::SC_NS);
+    out_period = sc_core::sc_time(5.0, sc_core::SC_NS);
+    SC_THREAD(write_tx);
+    SC_THREAD(read_tx);
+  }
+
+  virtual void build_phase(uvm::uvm_phase& phase){
+    test_base::build_phase(phase);
+    in_rate  = ack_rate_subscriber::type_id::create("in_rate", this);
+    out_rate = ack_rate_subscriber::type_id::create("out_rate", this);
+    if(! uvm::uvm_config_db<int>::get(this, "*", "uut_data_i_width", data_i_width) ||
+       ! uvm::uvm_config_db<int>::get(this, "*", "uut_data_o_width", data_o_width))
+      UVM_FATAL("NOCFG", "UUT parameters must be set for: " + get_full_name());
+  }
+
+  virtual void connect_phase(uvm::uvm_phase& phase){
+    env->wb4_mst_in_agent->mon->ap.connect(in_rate->analysis_export);
+    env->wb4_mst_out_agent->mon->ap.connect(out_rate->analysis_export);
+  }
+
+  void main_phase(uvm::uvm_phase& phase){
+    UVM_INFO(get_name()+"::"+__func__, "** MAIN PHASE**", uvm::UVM_NONE);
+
+    //
+    phase.raise_objection(this);
+    //set a drain-time for the environment if desired
+    sc_core::sc_time drain_time = sc_core::sc_time(333.0, sc_core::SC_NS);
+    phase.get_objection()->set_drain_time(this, drain_time);
+
+    if((data_i_width % data_o_width) == 0 || (data_o_width % data_i_width) == 0) {
+      UVM_ERROR(get_name()+"::"+__func__, "Not a gearbox FIFO, run with -GP_DATA_I_MSB=23 -GP_DATA_O_MSB=31 or -GP_DATA_I_MSB=9 -GP_DATA_O_MSB=7");
+      test_pass = false;
+    }
+    // Whole periods of the gearbox, twice the FIFO in stored (wider) words
+    // so the pointers wrap twice.
+    const int wide   = std::max(data_i_width, data_o_width);
+    const int period = data_i_width/std::gcd(data_i_width, data_o_width)*data_o_width;
+    const int turns  = (2*env->prd->depth*wide + period-1)/period;
+    n_in  = turns*period/data_i_width;
+    n_out = turns*period/data_o_width;
+
+    UVM_INFO(get_name()+"::"+__func__, "> Streaming "+std::to_string(n_in)+" words in, "+
+      std::to_string(n_out)+" words out", uvm::UVM_LOW);
+    in_rate->stamps.clear();
+    out_rate->stamps.clear();
+    this->trig.notify();
+    sc_core::wait(write_done & read_done);
+    sc_core::wait(sc_core::sc_time(50.0, sc_core::SC_NS));
+
+    // The port moving fewer bits per ns sets the pace, it must take a beat on
+    // every one of its clocks. The other one idles as much as the ratio of
+    // the two needs and no more, as the same bits go through both.
+    const bool in_paced = data_i_width*out_period < data_o_width*in_period;
+    const ack_rate_subscriber* paced = in_paced ? in_rate : out_rate;
+    double rate = paced->rate(in_paced ? in_period : out_period);
+    UVM_INFO(get_name()+"::"+__func__, std::string("> ")+(in_paced ? "Write" : "Read")+" acks/clk "+
+      std::to_string(rate), uvm::UVM_LOW);
+    if((int)in_rate->stamps.size() != n_in || (int)out_rate->stamps.size() != n_out || rate < 1.0) {
+      UVM_ERROR(get_name()+"::"+__func__, std::string(in_paced ? "Write" : "Read")+
+        " port idles beyond the width ratio, "+std::to_string(in_rate->stamps.size())+" of "+
+        std::to_string(n_in)+" written, "+std::to_string(out_rate->stamps.size())+" of "+
+        std::to_string(n_out)+" read");
+      test_pass = false;
+    }
+
+    phase.drop_objection(this);
+  }
+
+    // Positive Edge Clocking Block
+    void write_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_in; ++iter) {
+          write_seq = wb4_wr_request_seq::type_id::create("write_seq");
+          write_seq->req->delay = 0;
+          write_seq->req->dat_o = iter;
+          write_seq->start(env->wb4_mst_in_agent->sqr);
+        }
+        write_done.notify();
+      }
+    }
+
+    // Positive Edge Clocking Block
+    void read_tx() {
+      while(true) {
+        wait(trig); // Wait for the event to be triggered
+        for(int iter = 0; iter < n_out; ++iter) {
+          read_seq = wb4_rd_request_seq::type_id::create("read_seq");
+          read_seq->req->adr      = 0;
+          read_seq->req->delay    = 0;
+          read_seq->req->rsp_clks = 8;
+          read_seq->start(env->wb4_mst_out_agent->sqr);
+        }
+        read_done.notify();
+      }
+    }
+}; // test_fifo_gearbox
+
+
 #endif /* TEST_LIB_H_ */